@@ -0,0 +1,439 @@
+/*
+   ----------------------------------------------------------------------------
+   Runtime-Sized SIMD Bitset Built on the Bitwise Functors
+   (Word-Parallel and AVX2 and / or / xor / andnot, Popcount, Find-Next, Shift)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - The Bitwise Functors in stl_intro.txt (bit_and, bit_or, bit_xor) are
+       often applied with std::transform over a vector<char>, one byte per
+       flag, or over vector<bool>, whose proxy references are slow to
+       iterate. std::bitset is fast but its size is fixed at compile time.
+     - DynBitset stores bits in 64-bit words (bit i lives in word i / 64,
+       position i % 64) and applies the SAME functors, bit_and<uint64_t>,
+       bit_or<uint64_t>, bit_xor<uint64_t>, to whole words: 64 flags per
+       operation. With AVX2 four words (256 bits) are processed per step; the
+       CPU is checked once at run time.
+     - Invariant: bits beyond size() in the last word are always zero, so
+       count(), comparisons and find never see garbage.
+
+   Member Functions (with Complexity and Use Cases):
+
+     1. DynBitset(n, value = false)
+          - n bits, all cleared (or all set).
+
+     2. set(i), reset(i), flip(i), test(i), operator[](i)
+          - Single-bit access. Complexity: O(1). test(i) throws
+            std::out_of_range for i >= size(), like std::bitset::test.
+
+     3. &=, |=, ^=, andNot(other)   (andNot: this &= ~other)
+          - In-place set algebra between bitsets of equal size; a size mismatch
+            throws std::invalid_argument. &, |, ^ return a new bitset.
+          - Complexity: O(n / 64) word ops, O(n / 256) AVX2 ops.
+
+     4. count(), any(), none()
+          - Population count with the AVX2 nibble-lookup (pshufb) method, or the
+            POPCNT instruction, or a portable fallback.
+
+     5. findFirst(), findNext(i)
+          - Index of the first set bit (after i), or npos. All-zero stretches
+            are skipped 256 bits at a time. Complexity: O(gap / 256 + 1).
+
+     6. <<=, >>= (shift toward higher / lower indices, like std::bitset)
+          - Bits shifted past either end are dropped. Complexity: O(n / 64).
+
+   Compile:
+       g++ -std=c++17 -O2 dyn_bitset.cpp -o dyn_bitset
+   Run:
+       ./dyn_bitset [bits]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <bitset>
+#include <algorithm>   // For std::fill, std::transform
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For uint64_t
+#include <functional>  // For std::bit_and, std::bit_or, std::bit_xor
+#include <limits>      // For std::numeric_limits
+#include <memory>      // For std::make_unique
+#include <random>      // For test data
+#include <stdexcept>   // For std::out_of_range, std::invalid_argument
+#include <string>      // For std::stoull
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DYN_BITSET_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// a & ~b, the one set operation that has no standard functor.
+struct bit_andnot {
+    uint64_t operator()(uint64_t a, uint64_t b) const { return a & ~b; }
+};
+
+// ---------------------------------------------------------
+// Word kernels: portable and AVX2
+// ---------------------------------------------------------
+
+template <typename Op>
+void wordsApplyScalar(uint64_t* d, const uint64_t* s, size_t n, Op op) {
+    for (size_t i = 0; i < n; i++) d[i] = op(d[i], s[i]);
+}
+
+inline size_t popcountScalar(const uint64_t* w, size_t n) {
+    size_t c = 0;
+    for (size_t i = 0; i < n; i++) c += static_cast<size_t>(__builtin_popcountll(w[i]));
+    return c;
+}
+
+#ifdef DYN_BITSET_X86
+
+namespace avx2 {
+
+// The vector form of each functor, picked by overload on the functor type.
+__attribute__((target("avx2"))) inline __m256i vop(bit_and<uint64_t>, __m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+__attribute__((target("avx2"))) inline __m256i vop(bit_or<uint64_t>, __m256i a, __m256i b)  { return _mm256_or_si256(a, b); }
+__attribute__((target("avx2"))) inline __m256i vop(bit_xor<uint64_t>, __m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+__attribute__((target("avx2"))) inline __m256i vop(bit_andnot, __m256i a, __m256i b)         { return _mm256_andnot_si256(b, a); }
+
+template <typename Op>
+__attribute__((target("avx2"))) void wordsApply(uint64_t* d, const uint64_t* s, size_t n, Op op) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), vop(op, a, b));
+    }
+    wordsApplyScalar(d + i, s + i, n - i, op);
+}
+
+// Per-nibble lookup (Mula): popcount of each byte via two pshufb lookups,
+// then summed into 64-bit lanes with sad_epu8.
+__attribute__((target("avx2"))) inline size_t popcount(const uint64_t* w, size_t n) {
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        __m256i lo = _mm256_and_si256(v, low);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lut, lo), _mm256_shuffle_epi8(lut, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    size_t c = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; i++) c += static_cast<size_t>(_mm_popcnt_u64(w[i]));
+    return c;
+}
+
+// First word index >= from that is non-zero, or n.
+__attribute__((target("avx2"))) inline size_t firstNonZeroWord(const uint64_t* w, size_t from, size_t n) {
+    size_t i = from;
+    while (i < n && (i & 3)) {
+        if (w[i]) return i;
+        i++;
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        if (!_mm256_testz_si256(v, v)) break;
+    }
+    for (; i < n; i++)
+        if (w[i]) return i;
+    return n;
+}
+
+} // namespace avx2
+
+__attribute__((target("popcnt"))) inline size_t popcountHw(const uint64_t* w, size_t n) {
+    size_t c = 0;
+    for (size_t i = 0; i < n; i++) c += static_cast<size_t>(_mm_popcnt_u64(w[i]));
+    return c;
+}
+
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    return ok;
+}
+inline bool hasPopcnt() {
+    static const bool ok = __builtin_cpu_supports("popcnt");
+    return ok;
+}
+
+#endif // DYN_BITSET_X86
+
+template <typename Op>
+void wordsApply(uint64_t* d, const uint64_t* s, size_t n, Op op) {
+#ifdef DYN_BITSET_X86
+    if (hasAvx2()) return avx2::wordsApply(d, s, n, op);
+#endif
+    wordsApplyScalar(d, s, n, op);
+}
+
+inline size_t wordsPopcount(const uint64_t* w, size_t n) {
+#ifdef DYN_BITSET_X86
+    if (hasAvx2()) return avx2::popcount(w, n);
+    if (hasPopcnt()) return popcountHw(w, n);
+#endif
+    return popcountScalar(w, n);
+}
+
+inline size_t firstNonZeroWord(const uint64_t* w, size_t from, size_t n) {
+#ifdef DYN_BITSET_X86
+    if (hasAvx2()) return avx2::firstNonZeroWord(w, from, n);
+#endif
+    while (from < n && w[from] == 0) from++;
+    return from;
+}
+
+// ---------------------------------------------------------
+// DynBitset
+// ---------------------------------------------------------
+
+class DynBitset {
+public:
+    static constexpr size_t npos = numeric_limits<size_t>::max();
+
+    DynBitset() = default;
+    explicit DynBitset(size_t n, bool value = false)
+        : bits_(n), words_((n + 63) / 64, value ? ~uint64_t(0) : 0) {
+        trim();
+    }
+
+    size_t size() const { return bits_; }
+    size_t wordCount() const { return words_.size(); }
+    const uint64_t* words() const { return words_.data(); }
+
+    bool operator[](size_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+    bool test(size_t i) const {
+        if (i >= bits_) throw out_of_range("DynBitset::test");
+        return (*this)[i];
+    }
+    DynBitset& set(size_t i)   { words_[i >> 6] |= uint64_t(1) << (i & 63); return *this; }
+    DynBitset& reset(size_t i) { words_[i >> 6] &= ~(uint64_t(1) << (i & 63)); return *this; }
+    DynBitset& flip(size_t i)  { words_[i >> 6] ^= uint64_t(1) << (i & 63); return *this; }
+    DynBitset& set()   { fill(words_.begin(), words_.end(), ~uint64_t(0)); trim(); return *this; }
+    DynBitset& reset() { fill(words_.begin(), words_.end(), 0); return *this; }
+
+    DynBitset& operator&=(const DynBitset& o) { return apply(o, bit_and<uint64_t>()); }
+    DynBitset& operator|=(const DynBitset& o) { return apply(o, bit_or<uint64_t>()); }
+    DynBitset& operator^=(const DynBitset& o) { return apply(o, bit_xor<uint64_t>()); }
+    DynBitset& andNot(const DynBitset& o)     { return apply(o, bit_andnot()); }
+
+    friend DynBitset operator&(DynBitset a, const DynBitset& b) { return a &= b; }
+    friend DynBitset operator|(DynBitset a, const DynBitset& b) { return a |= b; }
+    friend DynBitset operator^(DynBitset a, const DynBitset& b) { return a ^= b; }
+    bool operator==(const DynBitset& o) const { return bits_ == o.bits_ && words_ == o.words_; }
+    bool operator!=(const DynBitset& o) const { return !(*this == o); }
+
+    size_t count() const { return wordsPopcount(words_.data(), words_.size()); }
+    bool any() const { return firstNonZeroWord(words_.data(), 0, words_.size()) != words_.size(); }
+    bool none() const { return !any(); }
+
+    size_t findFirst() const { return findFrom(0); }
+    size_t findNext(size_t i) const { return i + 1 >= bits_ ? npos : findFrom(i + 1); }
+
+    // Bit i moves to i + k.
+    DynBitset& operator<<=(size_t k) {
+        size_t n = words_.size();
+        if (k >= bits_) return reset();
+        size_t ws = k >> 6, bs = k & 63;
+        for (size_t i = n; i-- > ws;) {
+            uint64_t w = words_[i - ws] << bs;
+            if (bs && i > ws) w |= words_[i - ws - 1] >> (64 - bs);
+            words_[i] = w;
+        }
+        fill(words_.begin(), words_.begin() + ws, 0);
+        trim();
+        return *this;
+    }
+
+    // Bit i moves to i - k.
+    DynBitset& operator>>=(size_t k) {
+        size_t n = words_.size();
+        if (k >= bits_) return reset();
+        size_t ws = k >> 6, bs = k & 63;
+        for (size_t i = 0; i + ws < n; i++) {
+            uint64_t w = words_[i + ws] >> bs;
+            if (bs && i + ws + 1 < n) w |= words_[i + ws + 1] << (64 - bs);
+            words_[i] = w;
+        }
+        fill(words_.end() - ws, words_.end(), 0);
+        return *this;
+    }
+
+private:
+    template <typename Op>
+    DynBitset& apply(const DynBitset& o, Op op) {
+        if (o.bits_ != bits_)
+            throw invalid_argument("DynBitset: operands differ in size");
+        wordsApply(words_.data(), o.words_.data(), words_.size(), op);
+        return *this;
+    }
+
+    size_t findFrom(size_t i) const {
+        if (i >= bits_) return npos;   // also covers an empty bitset
+        size_t wi = i >> 6;
+        uint64_t w = words_[wi] & (~uint64_t(0) << (i & 63));
+        if (w) return (wi << 6) + static_cast<size_t>(__builtin_ctzll(w));
+        wi = firstNonZeroWord(words_.data(), wi + 1, words_.size());
+        if (wi == words_.size()) return npos;
+        return (wi << 6) + static_cast<size_t>(__builtin_ctzll(words_[wi]));
+    }
+
+    void trim() {
+        if (bits_ & 63) words_.back() &= (uint64_t(1) << (bits_ & 63)) - 1;
+    }
+
+    size_t bits_ = 0;
+    vector<uint64_t> words_;
+};
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double bestMillis(int reps, F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < reps; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+// std::bitset needs its size at compile time; this is the benchmark size
+// unless one is passed on the command line (then std::bitset is skipped).
+constexpr size_t BenchBits = size_t(1) << 28;
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        DynBitset a(200), b(200);
+        for (size_t i = 0; i < 200; i += 3) a.set(i);
+        for (size_t i = 0; i < 200; i += 5) b.set(i);
+
+        DynBitset both = a & b;   // multiples of 15
+        cout << "a & b set bits: ";
+        for (size_t i = both.findFirst(); i != DynBitset::npos; i = both.findNext(i)) cout << i << " ";
+        cout << "\n";
+        cout << "count(a) = " << a.count() << ", count(a | b) = " << (a | b).count()
+             << ", count(a ^ b) = " << (a ^ b).count() << "\n";
+
+        DynBitset onlyA = a;
+        onlyA.andNot(b);
+        cout << "count(a & ~b) = " << onlyA.count() << "\n";
+
+        DynBitset s(130);
+        s.set(0).set(64).set(129);
+        s <<= 1;
+        cout << "after <<= 1: ";
+        for (size_t i = s.findFirst(); i != DynBitset::npos; i = s.findNext(i)) cout << i << " ";   // 1 65
+        cout << "\n";
+
+        try {
+            a &= DynBitset(100);
+        } catch (const invalid_argument& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against std::bitset
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check against std::bitset\n";
+        constexpr size_t N = 1000;
+        mt19937_64 rng(4);
+        bool ok = true;
+        for (int round = 0; round < 50; round++) {
+            bitset<N> sa, sb;
+            DynBitset da(N), db(N);
+            for (size_t i = 0; i < N; i++) {
+                if (rng() % 7 == 0) { sa.set(i); da.set(i); }
+                if (rng() % 3 == 0) { sb.set(i); db.set(i); }
+            }
+            auto same = [&](const bitset<N>& s, const DynBitset& d) {
+                if (s.count() != d.count()) return false;
+                for (size_t i = 0; i < N; i++)
+                    if (s[i] != d[i]) return false;
+                return true;
+            };
+            ok &= same(sa & sb, da & db) && same(sa | sb, da | db) && same(sa ^ sb, da ^ db);
+            ok &= same(sa & ~sb, DynBitset(da).andNot(db));
+            size_t k = rng() % 300;
+            ok &= same(sa << k, DynBitset(da) <<= k) && same(sa >> k, DynBitset(da) >>= k);
+            size_t expectFirst = DynBitset::npos;
+            for (size_t i = k; i < N; i++)
+                if (sa[i]) { expectFirst = i; break; }
+            ok &= (k == 0 ? da.findFirst() : da.findNext(k - 1)) == expectFirst;
+        }
+        DynBitset empty, zero(0);
+        ok &= empty.findFirst() == DynBitset::npos && zero.findFirst() == DynBitset::npos && zero.count() == 0;
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark against vector<bool> and std::bitset
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoull(argv[1]) : BenchBits;
+        cout << "Section C: Benchmark, " << n << " bits (ms)\n";
+        mt19937_64 rng(9);
+        DynBitset da(n), db(n);
+        vector<bool> va(n), vb(n);
+        for (size_t i = 0; i < n; i++) {
+            if (rng() & 1) { da.set(i); va[i] = true; }
+            if (rng() % 5 == 0) { db.set(i); vb[i] = true; }
+        }
+        volatile size_t sink = 0;
+
+        double vAnd = bestMillis(3, [&] {
+            transform(va.begin(), va.end(), vb.begin(), va.begin(), logical_and<bool>());
+        });
+        double vCount = bestMillis(3, [&] { sink = count(va.begin(), va.end(), true); });
+        double dAnd = bestMillis(3, [&] { da &= db; });
+        double dXor = bestMillis(3, [&] { da ^= db; });
+        double dCount = bestMillis(3, [&] { sink = da.count(); });
+        double dShift = bestMillis(3, [&] { da <<= 3; });
+        DynBitset sparse(n);
+        sparse.set(n - 1);
+        double dFind = bestMillis(3, [&] { sink = sparse.findFirst(); });
+
+        cout << "  and           : vector<bool> " << vAnd << "   DynBitset " << dAnd;
+        if (n == BenchBits) {
+            auto sa = make_unique<bitset<BenchBits>>(), sb = make_unique<bitset<BenchBits>>();
+            for (size_t i = da.findFirst(); i != DynBitset::npos; i = da.findNext(i)) sa->set(i);
+            for (size_t i = db.findFirst(); i != DynBitset::npos; i = db.findNext(i)) sb->set(i);
+            double sAnd = bestMillis(3, [&] { *sa &= *sb; });
+            double sXor = bestMillis(3, [&] { *sa ^= *sb; });
+            double sCount = bestMillis(3, [&] { sink = sa->count(); });
+            double sShift = bestMillis(3, [&] { *sa <<= 3; });
+            cout << "   std::bitset " << sAnd << "\n";
+            cout << "  xor           : DynBitset " << dXor << "   std::bitset " << sXor << "\n";
+            cout << "  count         : vector<bool> " << vCount << "   DynBitset " << dCount
+                 << "   std::bitset " << sCount << "\n";
+            cout << "  shift <<= 3   : DynBitset " << dShift << "   std::bitset " << sShift << "\n";
+        } else {
+            cout << "\n  xor           : DynBitset " << dXor << "\n";
+            cout << "  count         : vector<bool> " << vCount << "   DynBitset " << dCount << "\n";
+            cout << "  shift <<= 3   : DynBitset " << dShift << "\n";
+        }
+        cout << "  findFirst (one bit at the end): DynBitset " << dFind << "\n";
+    }
+
+    return 0;
+}
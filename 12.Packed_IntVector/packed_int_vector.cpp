@@ -0,0 +1,553 @@
+/*
+   ----------------------------------------------------------------------------
+   Bit-Packed Integer Vector
+   (Runtime Bit Width, AVX2 Bulk Unpack, Delta + Varint / Group-Varint)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - vector<int> (stl_vector.cpp) spends 32 bits per element even when every
+       value fits in 11. PackedIntVector stores each value in exactly w bits,
+       w chosen at run time (1..64), back to back in 64-bit words:
+
+           value i occupies bits [i * w, i * w + w) of the word stream
+
+       so 11-bit values take 11/32 of the memory of vector<int>.
+     - Random access reads at most two words. Bulk unpack decodes 8 values per
+       AVX2 step for w <= 25: a group of 8 values is exactly w bytes, each
+       128-bit lane is loaded at a byte offset, one pshufb moves the 4 bytes
+       around every value into its own 32-bit slot, a per-slot variable shift
+       (vpsrlvd) drops the leading bits and an AND drops the trailing ones.
+       The shuffle and shift vectors depend only on w and are built once.
+     - For SORTED data the gaps are small even when the values are large.
+       DeltaVector stores gaps instead, either as
+         Varint:       7 data bits per byte, high bit = "more bytes follow"
+         GroupVarint:  one control byte (2-bit length code per value) for
+                       each group of 4 values, then their 1-4 byte payloads.
+       Group-varint decodes 4 values with one table-driven pshufb, then
+       rebuilds the values with an in-register prefix sum. A skip entry every
+       128 values gives get(i) without decoding from the start.
+
+   Class PackedIntVector (with Complexity):
+
+     1. PackedIntVector(width) / PackedIntVector(width, n)
+          - Empty vector, or n zeros, of w-bit values (1 <= w <= 64); an
+            invalid width throws std::invalid_argument.
+        PackedIntVector::fromValues(values)
+          - Picks the smallest width that holds max(values).
+
+     2. get(i), operator[](i), at(i), set(i, v)
+          - O(1). at(i) throws std::out_of_range; set / push_back throw
+            std::invalid_argument for a value that does not fit in w bits.
+
+     3. push_back(v), size(), width(), bytes()
+          - Amortised O(1) append, like vector::push_back.
+
+     4. unpack(first, count, out)
+          - Decodes count values into uint32_t out[] (w <= 32).
+          - O(count), AVX2 for w <= 25 when the CPU supports it.
+
+   Class DeltaVector (with Complexity):
+
+     1. DeltaVector(sorted, DeltaCoding::Varint / GroupVarint)
+          - Input must be non-decreasing, else std::invalid_argument. O(n).
+
+     2. get(i)
+          - Decodes from the nearest skip entry: O(128).
+
+     3. decode(out), size(), bytes()
+          - Decodes all values into uint32_t out[]. O(n).
+
+   Compile:
+       g++ -std=c++17 -O2 packed_int_vector.cpp -o packed_int_vector
+   Run:
+       ./packed_int_vector [values]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::sort, std::is_sorted, std::max_element
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For uint64_t, uint32_t, uint8_t
+#include <cstring>     // For std::memcpy
+#include <limits>      // For std::numeric_limits
+#include <random>      // For test data
+#include <stdexcept>   // For std::invalid_argument, std::out_of_range
+#include <string>      // For std::stoull
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PACKED_INT_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+#ifdef PACKED_INT_X86
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+}
+#endif
+
+// ---------------------------------------------------------
+// PackedIntVector
+// ---------------------------------------------------------
+
+class PackedIntVector {
+public:
+    // Widths up to this use the AVX2 unpack: a value plus its bit offset
+    // inside its first byte (0..7) must fit in one 32-bit slot.
+    static constexpr unsigned SimdMaxWidth = 25;
+
+    explicit PackedIntVector(unsigned width, size_t n = 0) : w_(width) {
+        if (width == 0 || width > 64) throw invalid_argument("PackedIntVector: width must be 1..64");
+        mask_ = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        resize(n);
+    }
+
+    static unsigned widthFor(uint64_t maxValue) {
+        return maxValue == 0 ? 1 : 64 - static_cast<unsigned>(__builtin_clzll(maxValue));
+    }
+
+    template <typename T>
+    static PackedIntVector fromValues(const vector<T>& values) {
+        uint64_t mx = 0;
+        for (T v : values) mx = max<uint64_t>(mx, static_cast<uint64_t>(v));
+        PackedIntVector p(widthFor(mx), values.size());
+        for (size_t i = 0; i < values.size(); i++) p.setUnchecked(i, static_cast<uint64_t>(values[i]));
+        return p;
+    }
+
+    size_t size() const { return n_; }
+    unsigned width() const { return w_; }
+    size_t bytes() const { return words_.capacity() * sizeof(uint64_t); }
+
+    uint64_t get(size_t i) const {
+        size_t bit = i * w_;
+        const uint64_t* p = &words_[bit / 64];
+        unsigned off = bit & 63;
+        // Second word shifted in branch-free; (x << 1) << (63 - off) is 0 for off == 0.
+        return ((p[0] >> off) | ((p[1] << 1) << (63 - off))) & mask_;
+    }
+    uint64_t operator[](size_t i) const { return get(i); }
+    uint64_t at(size_t i) const {
+        if (i >= n_) throw out_of_range("PackedIntVector::at");
+        return get(i);
+    }
+
+    void set(size_t i, uint64_t v) {
+        if (i >= n_) throw out_of_range("PackedIntVector::set");
+        if (v & ~mask_) throw invalid_argument("PackedIntVector: value does not fit in width");
+        setUnchecked(i, v);
+    }
+
+    void push_back(uint64_t v) {
+        if (v & ~mask_) throw invalid_argument("PackedIntVector: value does not fit in width");
+        resize(n_ + 1);
+        setUnchecked(n_ - 1, v);
+    }
+
+    void resize(size_t n) {
+        // +1 word so get() may always read p[1]; +4 so a 16-byte SIMD load
+        // starting inside the last value stays in bounds.
+        size_t need = (n * w_ + 63) / 64 + 5;
+        if (need > words_.size()) {
+            if (need > words_.capacity()) words_.reserve(max(need, words_.capacity() * 2));
+            words_.resize(need, 0);
+        }
+        for (size_t i = n; i < n_; i++) setUnchecked(i, 0);   // shrinking: keep padding zero
+        n_ = n;
+    }
+
+    void unpack(size_t first, size_t count, uint32_t* out) const {
+        if (w_ > 32) throw invalid_argument("PackedIntVector::unpack: width > 32");
+        if (first + count > n_) throw out_of_range("PackedIntVector::unpack");
+        size_t i = first, last = first + count;
+#ifdef PACKED_INT_X86
+        if (w_ <= SimdMaxWidth && hasAvx2()) {
+            for (; i < last && (i & 7); i++) *out++ = static_cast<uint32_t>(get(i));
+            size_t groups = (last - i) / 8;
+            unpackAvx2(reinterpret_cast<const uint8_t*>(words_.data()) + i / 8 * w_, groups, out);
+            i += groups * 8;
+            out += groups * 8;
+        }
+#endif
+        unpackScalar(i, last, out);
+    }
+
+    // Portable decoder: streams through the words with a 64-bit bit buffer.
+    void unpackScalar(size_t first, size_t last, uint32_t* out) const {
+        if (first >= last) return;
+        size_t bit = first * w_;
+        const uint64_t* p = &words_[bit / 64];
+        unsigned off = bit & 63;
+        uint64_t cur = *p++;
+        for (size_t i = first; i < last; i++) {
+            uint64_t v = cur >> off;
+            off += w_;
+            if (off >= 64) {
+                off -= 64;
+                cur = *p++;
+                if (off) v |= cur << (w_ - off);
+            }
+            *out++ = static_cast<uint32_t>(v & mask_);
+        }
+    }
+
+private:
+    void setUnchecked(size_t i, uint64_t v) {
+        size_t bit = i * w_;
+        uint64_t* p = &words_[bit / 64];
+        unsigned off = bit & 63;
+        p[0] = (p[0] & ~(mask_ << off)) | (v << off);
+        if (off + w_ > 64) {
+            unsigned spill = off + w_ - 64;
+            p[1] = (p[1] & ~((uint64_t(1) << spill) - 1)) | (v >> (64 - off));
+        }
+    }
+
+#ifdef PACKED_INT_X86
+    struct UnpackPlan {
+        alignas(32) uint8_t shuffle[32];
+        alignas(32) uint32_t shift[8];
+        size_t hiOffset;   // byte offset of lane 1 (values 4..7)
+    };
+
+    // Plans for every width 1..25, built once. Group start is byte aligned
+    // because 8 values of w bits are exactly w bytes.
+    static const UnpackPlan& plan(unsigned w) {
+        static const vector<UnpackPlan> plans = [] {
+            vector<UnpackPlan> v(SimdMaxWidth + 1);
+            for (unsigned width = 1; width <= SimdMaxWidth; width++) {
+                UnpackPlan& p = v[width];
+                p.hiOffset = 4 * width / 8;
+                for (unsigned j = 0; j < 8; j++) {
+                    unsigned lane = j / 4;
+                    size_t bit = j * width - 8 * (lane ? p.hiOffset : 0);
+                    for (unsigned b = 0; b < 4; b++) {
+                        size_t src = bit / 8 + b;
+                        p.shuffle[j * 4 + b] = src < 16 ? static_cast<uint8_t>(src) : 0x80;
+                    }
+                    p.shift[j] = bit & 7;
+                }
+            }
+            return v;
+        }();
+        return plans[w];
+    }
+
+    __attribute__((target("avx2"))) void unpackAvx2(const uint8_t* src, size_t groups, uint32_t* out) const {
+        const UnpackPlan& p = plan(w_);
+        const __m256i shuf = _mm256_load_si256(reinterpret_cast<const __m256i*>(p.shuffle));
+        const __m256i sh = _mm256_load_si256(reinterpret_cast<const __m256i*>(p.shift));
+        const __m256i mask = _mm256_set1_epi32(static_cast<int>(mask_));
+        for (size_t g = 0; g < groups; g++, src += w_, out += 8) {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + p.hiOffset));
+            __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            v = _mm256_and_si256(_mm256_srlv_epi32(_mm256_shuffle_epi8(v, shuf), sh), mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+        }
+    }
+#endif
+
+    unsigned w_;
+    uint64_t mask_;
+    size_t n_ = 0;
+    vector<uint64_t> words_;
+};
+
+// ---------------------------------------------------------
+// DeltaVector: gaps of a sorted sequence as varint / group-varint
+// ---------------------------------------------------------
+
+enum class DeltaCoding { Varint, GroupVarint };
+
+class DeltaVector {
+public:
+    static constexpr size_t SkipEvery = 128;   // multiple of 4: skips land on group boundaries
+
+    DeltaVector(const vector<uint32_t>& sorted, DeltaCoding coding) : coding_(coding), n_(sorted.size()) {
+        if (!is_sorted(sorted.begin(), sorted.end()))
+            throw invalid_argument("DeltaVector: input must be sorted");
+        uint32_t prev = 0;
+        for (size_t i = 0; i < n_; i += (coding_ == DeltaCoding::Varint ? 1 : 4)) {
+            if (i % SkipEvery == 0) skips_.push_back({ bytes_.size(), prev });
+            if (coding_ == DeltaCoding::Varint) {
+                putVarint(sorted[i] - prev);
+                prev = sorted[i];
+            } else {
+                uint32_t gap[4] = { 0, 0, 0, 0 };
+                for (size_t k = 0; k < 4 && i + k < n_; k++) {
+                    gap[k] = sorted[i + k] - prev;
+                    prev = sorted[i + k];
+                }
+                putGroup(gap);
+            }
+        }
+        bytes_.resize(bytes_.size() + 16, 0);   // SIMD decode reads 16 bytes past any group
+    }
+
+    size_t size() const { return n_; }
+    size_t bytes() const { return bytes_.size() + skips_.size() * sizeof(Skip); }
+
+    uint32_t get(size_t i) const {
+        if (i >= n_) throw out_of_range("DeltaVector::get");
+        const Skip& s = skips_[i / SkipEvery];
+        uint32_t tmp[SkipEvery];
+        size_t len = min(SkipEvery, n_ - i / SkipEvery * SkipEvery);
+        decodeRun(bytes_.data() + s.offset, s.base, len, tmp);
+        return tmp[i % SkipEvery];
+    }
+
+    void decode(uint32_t* out) const { decodeRun(bytes_.data(), 0, n_, out); }
+
+private:
+    struct Skip {
+        size_t offset;   // byte offset of the run
+        uint32_t base;   // value preceding the run
+    };
+
+    void putVarint(uint32_t v) {
+        while (v >= 0x80) {
+            bytes_.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        bytes_.push_back(static_cast<uint8_t>(v));
+    }
+
+    static unsigned byteLen(uint32_t v) { return v < (1u << 8) ? 1 : v < (1u << 16) ? 2 : v < (1u << 24) ? 3 : 4; }
+
+    void putGroup(const uint32_t* gap) {
+        uint8_t ctrl = 0;
+        for (unsigned k = 0; k < 4; k++) ctrl |= static_cast<uint8_t>((byteLen(gap[k]) - 1) << (2 * k));
+        bytes_.push_back(ctrl);
+        for (unsigned k = 0; k < 4; k++)
+            for (unsigned b = 0; b < byteLen(gap[k]); b++) bytes_.push_back(static_cast<uint8_t>(gap[k] >> (8 * b)));
+    }
+
+    void decodeRun(const uint8_t* p, uint32_t prev, size_t count, uint32_t* out) const {
+        if (coding_ == DeltaCoding::Varint) {
+            for (size_t i = 0; i < count; i++) {
+                uint32_t v = 0;
+                unsigned shift = 0;
+                uint8_t b;
+                do {
+                    b = *p++;
+                    v |= uint32_t(b & 0x7F) << shift;
+                    shift += 7;
+                } while (b & 0x80);
+                prev += v;
+                out[i] = prev;
+            }
+            return;
+        }
+#ifdef PACKED_INT_X86
+        if (hasAvx2()) {
+            size_t full = count / 4 * 4;
+            p = decodeGroupsSimd(p, prev, full, out);
+            if (full) prev = out[full - 1];
+            decodeGroupsScalar(p, prev, full, count, out);
+            return;
+        }
+#endif
+        decodeGroupsScalar(p, prev, 0, count, out);
+    }
+
+    static void decodeGroupsScalar(const uint8_t* p, uint32_t prev, size_t i, size_t count, uint32_t* out) {
+        for (; i < count; i += 4) {
+            uint8_t ctrl = *p++;
+            for (unsigned k = 0; k < 4; k++) {
+                unsigned len = ((ctrl >> (2 * k)) & 3) + 1;
+                uint32_t v = 0;
+                for (unsigned b = 0; b < len; b++) v |= uint32_t(p[b]) << (8 * b);
+                p += len;
+                prev += v;
+                if (i + k < count) out[i + k] = prev;
+            }
+        }
+    }
+
+#ifdef PACKED_INT_X86
+    struct GroupTable {
+        alignas(16) uint8_t shuffle[256][16];
+        uint8_t length[256];
+    };
+
+    static const GroupTable& groupTable() {
+        static const GroupTable t = [] {
+            GroupTable g{};
+            for (unsigned c = 0; c < 256; c++) {
+                unsigned src = 0;
+                for (unsigned k = 0; k < 4; k++) {
+                    unsigned len = ((c >> (2 * k)) & 3) + 1;
+                    for (unsigned b = 0; b < 4; b++)
+                        g.shuffle[c][k * 4 + b] = b < len ? static_cast<uint8_t>(src + b) : 0x80;
+                    src += len;
+                }
+                g.length[c] = static_cast<uint8_t>(src);
+            }
+            return g;
+        }();
+        return t;
+    }
+
+    __attribute__((target("avx2"))) static const uint8_t* decodeGroupsSimd(const uint8_t* p, uint32_t prev, size_t count,
+                                                                         uint32_t* out) {
+        const GroupTable& t = groupTable();
+        __m128i run = _mm_set1_epi32(static_cast<int>(prev));
+        for (size_t i = 0; i < count; i += 4) {
+            uint8_t ctrl = *p++;
+            __m128i gaps = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                                            _mm_load_si128(reinterpret_cast<const __m128i*>(t.shuffle[ctrl])));
+            p += t.length[ctrl];
+            gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 4));   // inclusive prefix sum of 4 gaps
+            gaps = _mm_add_epi32(gaps, _mm_slli_si128(gaps, 8));
+            run = _mm_add_epi32(gaps, run);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), run);
+            run = _mm_shuffle_epi32(run, 0xFF);                    // broadcast the last value
+        }
+        return p;
+    }
+#endif
+
+    DeltaCoding coding_;
+    size_t n_;
+    vector<uint8_t> bytes_;
+    vector<Skip> skips_;
+};
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double bestMs(F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < 5; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        vector<int> v = { 5, 1000, 2047, 0, 42 };
+        PackedIntVector p = PackedIntVector::fromValues(v);
+        cout << "width = " << p.width() << " bits\n";   // 11
+        p.push_back(7);
+        p.set(0, 6);
+        cout << "values:";
+        for (size_t i = 0; i < p.size(); i++) cout << " " << p[i];
+        cout << "\n";
+        try {
+            p.push_back(4096);
+        } catch (const invalid_argument& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+
+        DeltaVector d({ 3, 10, 10, 500, 70000 }, DeltaCoding::GroupVarint);
+        cout << "delta get(3) = " << d.get(3) << "\n\n";   // 500
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        mt19937_64 rng(4);
+        bool ok = true;
+        for (unsigned w = 1; w <= 64; w++) {
+            uint64_t mask = w == 64 ? ~uint64_t(0) : (uint64_t(1) << w) - 1;
+            size_t n = 1000 + rng() % 64;
+            vector<uint64_t> ref(n);
+            PackedIntVector p(w);
+            for (auto& x : ref) {
+                x = rng() & mask;
+                p.push_back(x);
+            }
+            for (size_t i = 0; i < n; i += 7) {   // overwrite some, neighbours must survive
+                ref[i] = rng() & mask;
+                p.set(i, ref[i]);
+            }
+            for (size_t i = 0; i < n; i++) ok &= p[i] == ref[i];
+            if (w <= 32) {
+                for (size_t first : { size_t(0), size_t(3), size_t(8), size_t(13) }) {
+                    vector<uint32_t> out(n - first);
+                    p.unpack(first, n - first, out.data());
+                    for (size_t i = first; i < n; i++) ok &= out[i - first] == ref[i];
+                }
+            }
+        }
+        for (size_t n : { 0, 1, 5, 127, 128, 129, 1000 }) {
+            vector<uint32_t> s(n);
+            for (auto& x : s) x = static_cast<uint32_t>(rng() % (rng() % 2 ? 300 : 1u << 31));
+            sort(s.begin(), s.end());
+            for (DeltaCoding c : { DeltaCoding::Varint, DeltaCoding::GroupVarint }) {
+                DeltaVector d(s, c);
+                vector<uint32_t> out(n);
+                d.decode(out.data());
+                ok &= out == s;
+                for (size_t i = 0; i < n; i += 11) ok &= d.get(i) == s[i];
+            }
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Memory and decode speed
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoull(argv[1]) : (size_t(1) << 25);
+        cout << "Section C: Benchmark, " << n << " values\n";
+        mt19937_64 rng(9);
+
+        vector<int> plain(n);
+        for (auto& x : plain) x = static_cast<int>(rng() % 2048);   // 11-bit values
+        PackedIntVector packed = PackedIntVector::fromValues(plain);
+        double mb = 1 << 20;
+        cout << "  11-bit values: vector<int> " << n * sizeof(int) / mb << " MB, packed "
+             << packed.bytes() / mb << " MB (" << double(n * sizeof(int)) / packed.bytes() << "x smaller)\n";
+
+        vector<uint32_t> out(n);
+        auto gbps = [&](double ms) { return double(n) * sizeof(uint32_t) / (ms * 1e6); };
+        double tCopy = bestMs([&] { memcpy(out.data(), plain.data(), n * sizeof(int)); });
+        double tScalar = bestMs([&] { packed.unpackScalar(0, n, out.data()); });
+        double tSimd = bestMs([&] { packed.unpack(0, n, out.data()); });
+        cout << "  decode (GB/s of uint32 output): memcpy of vector<int> " << gbps(tCopy) << ", scalar "
+             << gbps(tScalar) << ", AVX2 " << gbps(tSimd) << "\n";
+
+        const size_t q = 4'000'000;
+        vector<size_t> idx(q);
+        for (auto& i : idx) i = rng() % n;
+        volatile uint64_t sink = 0;
+        double tRandInt = bestMs([&] { uint64_t s = 0; for (size_t i : idx) s += plain[i]; sink = s; });
+        double tRandPacked = bestMs([&] { uint64_t s = 0; for (size_t i : idx) s += packed[i]; sink = s; });
+        cout << "  random access (ns): vector<int> " << tRandInt * 1e6 / q << ", packed " << tRandPacked * 1e6 / q
+             << "\n";
+
+        vector<uint32_t> sorted(n);
+        for (auto& x : sorted) x = static_cast<uint32_t>(rng() % (uint64_t(n) * 64));   // average gap ~64
+        sort(sorted.begin(), sorted.end());
+        PackedIntVector sortedPacked = PackedIntVector::fromValues(sorted);
+        cout << "  sorted values (bytes/value): vector<uint32_t> 4, packed "
+             << double(sortedPacked.bytes()) / n;
+        for (DeltaCoding c : { DeltaCoding::Varint, DeltaCoding::GroupVarint }) {
+            DeltaVector d(sorted, c);
+            double t = bestMs([&] { d.decode(out.data()); });
+            cout << (c == DeltaCoding::Varint ? ", delta+varint " : ", delta+group-varint ")
+                 << double(d.bytes()) / n << " (" << gbps(t) << " GB/s)";
+        }
+        cout << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,625 @@
+/*
+   ----------------------------------------------------------------------------
+   Flat Iterative Segment Tree, Lazy Segment Tree and Fenwick Tree
+   (Monoid-Templated, Cache-Aligned std::vector Storage)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - All three trees live in ONE flat std::vector whose buffer is aligned to
+       a 64-byte cache line; no pointers, no recursion.
+     - SegTree<Monoid> is the bottom-up ("iterative") segment tree: leaves are
+       t[n .. 2n), node k has children 2k and 2k+1, so siblings are adjacent
+       and a pair of 8-byte nodes never straddles a cache line. Queries walk
+       from the two leaves upward; left and right partial results are kept
+       apart, so non-commutative monoids work too.
+     - A Monoid is a struct with
+           using value_type = T;
+           static T identity();
+           static T combine(const T& a, const T& b);   // associative
+       SumMonoid, MinMonoid, MaxMonoid are provided; any user struct works.
+     - LazySegTree<Action> adds range updates. An Action names its Monoid and
+       an update type F:
+           static F id();                         // "no update"
+           static F compose(const F& f, const F& g);  // f applied after g
+           static T apply(const F& f, const T& x, size_t len);
+       The value and the pending update of a node are stored side by side in
+       one Node, so a push-down touches one cache line per node. The size is
+       rounded up to a power of two so every node has a fixed length.
+     - Fenwick<T> (binary indexed tree) holds prefix sums in n slots. The
+       O(n) build adds each slot into its parent once instead of calling
+       add() n times, and lowerBound walks the implicit tree from the highest
+       power of two downward, O(log n) instead of O(log^2 n) for a binary
+       search over prefix().
+
+   Functions (with Complexity):
+
+     SegTree<M>(values) / SegTree<M>(n)     build, O(n)
+     set(i, v), get(i)                      O(log n) / O(1)
+     query(l, r)                            combine of [l, r), O(log n)
+     all()                                  combine of everything, O(log n)
+
+     LazySegTree<A>(values)                 build, O(n)
+     apply(l, r, f)                         update every element in [l, r)
+     query(l, r)                            O(log n) each
+
+     Fenwick<T>(values) / Fenwick<T>(n)     build, O(n)
+     add(i, delta), prefix(i) = sum[0, i)   O(log n)
+     rangeSum(l, r)                         O(log n)
+     lowerBound(target)                     smallest i with prefix(i + 1) >=
+                                            target (values must be >= 0),
+                                            size() if none. O(log n)
+
+     Ranges out of [0, n] or with l > r throw std::out_of_range.
+
+   Measured (Section C, n = 10^7, 5 * 10^6 updates + 5 * 10^6 queries, ms):
+     - Point set / range sum: set 972 vs 2107, query 1587 vs 5000
+       (iterative vs recursive).
+     - Range add is NOT a guaranteed win for the iterative lazy tree. It
+       pushes down and then rebuilds both boundary paths on every update,
+       about the work the recursive tree does going down and back up. One
+       run had it slower than the recursive tree (15011 vs 14588); others
+       had it ahead (6370 vs 10444, 4923 vs 11938). Range queries were
+       faster in every run (4588 vs 5950).
+     - Fenwick lowerBound: 4253 by descent vs 11395 by binary search.
+
+   Compile:
+       g++ -std=c++17 -O2 segment_tree.cpp -o segment_tree
+   Run:
+       ./segment_tree [n]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::min, std::max
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For int64_t
+#include <limits>      // For std::numeric_limits
+#include <new>         // For std::align_val_t
+#include <random>      // For test data
+#include <stdexcept>   // For std::out_of_range
+#include <string>      // For std::stoull
+
+using namespace std;
+
+// ---------------------------------------------------------
+// Cache-line aligned allocator for the flat tree storage
+// ---------------------------------------------------------
+
+template <typename T, size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(Align))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, align_val_t(Align)); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+template <typename T>
+using AlignedVector = vector<T, AlignedAllocator<T>>;
+
+// ---------------------------------------------------------
+// Monoids and lazy actions
+// ---------------------------------------------------------
+
+template <typename T>
+struct SumMonoid {
+    using value_type = T;
+    static T identity() { return T(); }
+    static T combine(const T& a, const T& b) { return a + b; }
+};
+
+template <typename T>
+struct MinMonoid {
+    using value_type = T;
+    static T identity() { return numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return min(a, b); }
+};
+
+template <typename T>
+struct MaxMonoid {
+    using value_type = T;
+    static T identity() { return numeric_limits<T>::lowest(); }
+    static T combine(const T& a, const T& b) { return max(a, b); }
+};
+
+// Range add, range sum: a node of length len grows by f * len.
+template <typename T>
+struct AddToSum {
+    using Monoid = SumMonoid<T>;
+    using F = T;
+    static F id() { return F(); }
+    static F compose(const F& f, const F& g) { return f + g; }
+    static T apply(const F& f, const T& x, size_t len) { return x + f * static_cast<T>(len); }
+};
+
+// Range add, range min: the minimum moves by f; padding stays at identity.
+template <typename T>
+struct AddToMin {
+    using Monoid = MinMonoid<T>;
+    using F = T;
+    static F id() { return F(); }
+    static F compose(const F& f, const F& g) { return f + g; }
+    static T apply(const F& f, const T& x, size_t) { return x == Monoid::identity() ? x : x + f; }
+};
+
+inline void checkRange(size_t l, size_t r, size_t n, const char* what) {
+    if (l > r || r > n) throw out_of_range(what);
+}
+
+// ---------------------------------------------------------
+// SegTree: bottom-up, n leaves at t[n .. 2n)
+// ---------------------------------------------------------
+
+template <typename Monoid>
+class SegTree {
+public:
+    using T = typename Monoid::value_type;
+
+    explicit SegTree(size_t n) : n_(n), t_(2 * n, Monoid::identity()) {}
+
+    explicit SegTree(const vector<T>& values) : n_(values.size()), t_(2 * values.size()) {
+        copy(values.begin(), values.end(), t_.begin() + n_);
+        for (size_t k = n_; k-- > 1;) t_[k] = Monoid::combine(t_[2 * k], t_[2 * k + 1]);
+        if (n_) t_[0] = Monoid::identity();
+    }
+
+    size_t size() const { return n_; }
+    T get(size_t i) const { return t_[n_ + i]; }
+
+    void set(size_t i, const T& v) {
+        if (i >= n_) throw out_of_range("SegTree::set");
+        size_t k = n_ + i;
+        t_[k] = v;
+        for (k >>= 1; k > 0; k >>= 1) t_[k] = Monoid::combine(t_[2 * k], t_[2 * k + 1]);
+    }
+
+    T query(size_t l, size_t r) const {
+        checkRange(l, r, n_, "SegTree::query");
+        T left = Monoid::identity(), right = Monoid::identity();
+        for (l += n_, r += n_; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) left = Monoid::combine(left, t_[l++]);
+            if (r & 1) right = Monoid::combine(t_[--r], right);
+        }
+        return Monoid::combine(left, right);
+    }
+
+    T all() const { return query(0, n_); }
+
+private:
+    size_t n_;
+    AlignedVector<T> t_;
+};
+
+// ---------------------------------------------------------
+// LazySegTree: power-of-two size, value + pending update per node
+// ---------------------------------------------------------
+
+template <typename Action>
+class LazySegTree {
+public:
+    using Monoid = typename Action::Monoid;
+    using T = typename Monoid::value_type;
+    using F = typename Action::F;
+
+    explicit LazySegTree(const vector<T>& values) : n_(values.size()) {
+        while ((size_t(1) << log_) < n_) log_++;
+        size_ = size_t(1) << log_;
+        t_.assign(2 * size_, Node{ Monoid::identity(), Action::id() });
+        for (size_t i = 0; i < n_; i++) t_[size_ + i].value = values[i];
+        for (size_t k = size_ - 1; k > 0; k--) pull(k);
+    }
+
+    size_t size() const { return n_; }
+
+    T query(size_t l, size_t r) {
+        checkRange(l, r, n_, "LazySegTree::query");
+        if (l == r) return Monoid::identity();
+        l += size_;
+        r += size_;
+        for (unsigned h = log_; h > 0; h--) {   // settle ancestors of both ends
+            if (((l >> h) << h) != l) push(l >> h, h);
+            if (((r >> h) << h) != r) push((r - 1) >> h, h);
+        }
+        T left = Monoid::identity(), right = Monoid::identity();
+        for (; l < r; l >>= 1, r >>= 1) {
+            if (l & 1) left = Monoid::combine(left, t_[l++].value);
+            if (r & 1) right = Monoid::combine(t_[--r].value, right);
+        }
+        return Monoid::combine(left, right);
+    }
+
+    void apply(size_t l, size_t r, const F& f) {
+        checkRange(l, r, n_, "LazySegTree::apply");
+        if (l == r) return;
+        l += size_;
+        r += size_;
+        for (unsigned h = log_; h > 0; h--) {
+            if (((l >> h) << h) != l) push(l >> h, h);
+            if (((r >> h) << h) != r) push((r - 1) >> h, h);
+        }
+        size_t l2 = l, r2 = r;
+        for (unsigned h = 0; l < r; l >>= 1, r >>= 1, h++) {
+            if (l & 1) applyNode(l++, f, h);
+            if (r & 1) applyNode(--r, f, h);
+        }
+        for (unsigned h = 1; h <= log_; h++) {   // recompute the ancestors of both ends
+            if (((l2 >> h) << h) != l2) pull(l2 >> h);
+            if (((r2 >> h) << h) != r2) pull((r2 - 1) >> h);
+        }
+    }
+
+private:
+    struct Node {
+        T value;
+        F lazy;
+    };
+
+    void pull(size_t k) { t_[k].value = Monoid::combine(t_[2 * k].value, t_[2 * k + 1].value); }
+
+    // Node k at height h covers 2^h leaves.
+    void applyNode(size_t k, const F& f, unsigned h) {
+        t_[k].value = Action::apply(f, t_[k].value, size_t(1) << h);
+        if (k < size_) t_[k].lazy = Action::compose(f, t_[k].lazy);
+    }
+
+    void push(size_t k, unsigned h) {
+        applyNode(2 * k, t_[k].lazy, h - 1);
+        applyNode(2 * k + 1, t_[k].lazy, h - 1);
+        t_[k].lazy = Action::id();
+    }
+
+    size_t n_;
+    unsigned log_ = 0;
+    size_t size_ = 1;
+    AlignedVector<Node> t_;
+};
+
+// ---------------------------------------------------------
+// Fenwick tree
+// ---------------------------------------------------------
+
+template <typename T>
+class Fenwick {
+public:
+    explicit Fenwick(size_t n) : t_(n + 1, T()) {}
+
+    explicit Fenwick(const vector<T>& values) : t_(values.size() + 1, T()) {
+        size_t n = values.size();
+        for (size_t i = 1; i <= n; i++) {
+            t_[i] += values[i - 1];
+            size_t parent = i + (i & (0 - i));
+            if (parent <= n) t_[parent] += t_[i];
+        }
+    }
+
+    size_t size() const { return t_.size() - 1; }
+
+    void add(size_t i, const T& delta) {
+        if (i >= size()) throw out_of_range("Fenwick::add");
+        for (i++; i < t_.size(); i += i & (0 - i)) t_[i] += delta;
+    }
+
+    T prefix(size_t i) const {
+        if (i > size()) throw out_of_range("Fenwick::prefix");
+        T s = T();
+        for (; i > 0; i &= i - 1) s += t_[i];
+        return s;
+    }
+
+    T rangeSum(size_t l, size_t r) const {
+        checkRange(l, r, size(), "Fenwick::rangeSum");
+        return prefix(r) - prefix(l);
+    }
+
+    size_t lowerBound(T target) const {
+        if (target <= T()) return 0;
+        size_t pos = 0, n = size();
+        size_t step = n ? size_t(1) << (63 - __builtin_clzll(n)) : 0;
+        for (; step > 0; step >>= 1) {
+            if (pos + step <= n && t_[pos + step] < target) {
+                pos += step;
+                target -= t_[pos];
+            }
+        }
+        return pos;   // prefix(pos) < target <= prefix(pos + 1)
+    }
+
+private:
+    AlignedVector<T> t_;   // 1-based: t_[i] covers (i - lowbit(i), i]
+};
+
+// ---------------------------------------------------------
+// Baselines: textbook recursive segment trees (4n nodes)
+// ---------------------------------------------------------
+
+struct RecursiveSumTree {
+    size_t n;
+    vector<int64_t> t;
+
+    explicit RecursiveSumTree(const vector<int64_t>& a) : n(a.size()), t(4 * a.size()) { build(a, 1, 0, n); }
+
+    void build(const vector<int64_t>& a, size_t k, size_t lo, size_t hi) {
+        if (hi - lo == 1) { t[k] = a[lo]; return; }
+        size_t mid = (lo + hi) / 2;
+        build(a, 2 * k, lo, mid);
+        build(a, 2 * k + 1, mid, hi);
+        t[k] = t[2 * k] + t[2 * k + 1];
+    }
+    void set(size_t i, int64_t v, size_t k, size_t lo, size_t hi) {
+        if (hi - lo == 1) { t[k] = v; return; }
+        size_t mid = (lo + hi) / 2;
+        if (i < mid) set(i, v, 2 * k, lo, mid);
+        else         set(i, v, 2 * k + 1, mid, hi);
+        t[k] = t[2 * k] + t[2 * k + 1];
+    }
+    int64_t query(size_t l, size_t r, size_t k, size_t lo, size_t hi) const {
+        if (r <= lo || hi <= l) return 0;
+        if (l <= lo && hi <= r) return t[k];
+        size_t mid = (lo + hi) / 2;
+        return query(l, r, 2 * k, lo, mid) + query(l, r, 2 * k + 1, mid, hi);
+    }
+    void set(size_t i, int64_t v) { set(i, v, 1, 0, n); }
+    int64_t query(size_t l, size_t r) const { return query(l, r, 1, 0, n); }
+};
+
+struct RecursiveLazySumTree {
+    size_t n;
+    vector<int64_t> t, lazy;
+
+    explicit RecursiveLazySumTree(const vector<int64_t>& a) : n(a.size()), t(4 * a.size()), lazy(4 * a.size()) {
+        build(a, 1, 0, n);
+    }
+
+    void build(const vector<int64_t>& a, size_t k, size_t lo, size_t hi) {
+        if (hi - lo == 1) { t[k] = a[lo]; return; }
+        size_t mid = (lo + hi) / 2;
+        build(a, 2 * k, lo, mid);
+        build(a, 2 * k + 1, mid, hi);
+        t[k] = t[2 * k] + t[2 * k + 1];
+    }
+    void push(size_t k, size_t lo, size_t mid, size_t hi) {
+        if (!lazy[k]) return;
+        t[2 * k] += lazy[k] * int64_t(mid - lo);
+        lazy[2 * k] += lazy[k];
+        t[2 * k + 1] += lazy[k] * int64_t(hi - mid);
+        lazy[2 * k + 1] += lazy[k];
+        lazy[k] = 0;
+    }
+    void add(size_t l, size_t r, int64_t f, size_t k, size_t lo, size_t hi) {
+        if (r <= lo || hi <= l) return;
+        if (l <= lo && hi <= r) { t[k] += f * int64_t(hi - lo); lazy[k] += f; return; }
+        size_t mid = (lo + hi) / 2;
+        push(k, lo, mid, hi);
+        add(l, r, f, 2 * k, lo, mid);
+        add(l, r, f, 2 * k + 1, mid, hi);
+        t[k] = t[2 * k] + t[2 * k + 1];
+    }
+    int64_t query(size_t l, size_t r, size_t k, size_t lo, size_t hi) {
+        if (r <= lo || hi <= l) return 0;
+        if (l <= lo && hi <= r) return t[k];
+        size_t mid = (lo + hi) / 2;
+        push(k, lo, mid, hi);
+        return query(l, r, 2 * k, lo, mid) + query(l, r, 2 * k + 1, mid, hi);
+    }
+    void add(size_t l, size_t r, int64_t f) { add(l, r, f, 1, 0, n); }
+    int64_t query(size_t l, size_t r) { return query(l, r, 1, 0, n); }
+};
+
+// A custom, non-commutative monoid: maximum subarray sum.
+struct MaxSubarray {
+    struct value_type {
+        int64_t sum, best, prefix, suffix;
+    };
+    static value_type identity() {
+        const int64_t ninf = numeric_limits<int64_t>::min() / 4;
+        return { 0, ninf, ninf, ninf };
+    }
+    static value_type combine(const value_type& a, const value_type& b) {
+        return { a.sum + b.sum, max({ a.best, b.best, a.suffix + b.prefix }), max(a.prefix, a.sum + b.prefix),
+                 max(b.suffix, b.sum + a.suffix) };
+    }
+    static value_type leaf(int64_t x) { return { x, x, x, x }; }
+};
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        vector<int64_t> a = { 5, -2, 7, 1, -6, 3, 4 };
+
+        SegTree<MinMonoid<int64_t>> mn(a);
+        cout << "min[1, 4) = " << mn.query(1, 4) << "\n";   // -2
+        mn.set(1, 10);
+        cout << "after set(1, 10): min[1, 4) = " << mn.query(1, 4) << "\n";   // 1
+
+        vector<MaxSubarray::value_type> leaves;
+        for (int64_t x : a) leaves.push_back(MaxSubarray::leaf(x));
+        SegTree<MaxSubarray> ms(leaves);
+        cout << "max subarray sum of all = " << ms.all().best << "\n";   // 12
+
+        LazySegTree<AddToSum<int64_t>> lz(a);
+        lz.apply(2, 6, 10);
+        cout << "after +10 on [2, 6): sum[0, 7) = " << lz.query(0, 7) << "\n";   // 52
+
+        Fenwick<int64_t> fw(vector<int64_t>{ 3, 0, 4, 1, 5 });
+        cout << "prefix(3) = " << fw.prefix(3) << ", lowerBound(8) = " << fw.lowerBound(8) << "\n";   // 7, 3
+        try {
+            mn.query(3, 9);
+        } catch (const out_of_range& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against brute force
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        mt19937_64 rng(2);
+        bool ok = true;
+        for (size_t n : { 1, 2, 3, 7, 8, 9, 100, 1000 }) {
+            vector<int64_t> a(n);
+            for (auto& x : a) x = static_cast<int64_t>(rng() % 100);
+            SegTree<SumMonoid<int64_t>> st(a);
+            SegTree<MaxMonoid<int64_t>> mx(a);
+            LazySegTree<AddToSum<int64_t>> ls(a);
+            LazySegTree<AddToMin<int64_t>> lm(a);
+            Fenwick<int64_t> fw(a);
+            for (int op = 0; op < 2000; op++) {
+                size_t l = rng() % (n + 1), r = rng() % (n + 1);
+                if (l > r) swap(l, r);
+                int64_t v = static_cast<int64_t>(rng() % 50);
+                switch (rng() % 4) {
+                case 0: {   // point set
+                    size_t i = rng() % n;
+                    fw.add(i, v - a[i]);
+                    a[i] = v;
+                    st.set(i, v);
+                    mx.set(i, v);
+                    ls.apply(i, i + 1, v - ls.query(i, i + 1));
+                    lm.apply(i, i + 1, v - lm.query(i, i + 1));
+                    break;
+                }
+                case 1:   // range add (lazy trees and fenwick via point adds)
+                    for (size_t i = l; i < r; i++) {
+                        a[i] += v;
+                        st.set(i, a[i]);
+                        mx.set(i, a[i]);
+                        fw.add(i, v);
+                    }
+                    ls.apply(l, r, v);
+                    lm.apply(l, r, v);
+                    break;
+                default: {
+                    int64_t sum = 0, hi = numeric_limits<int64_t>::lowest(), lo = numeric_limits<int64_t>::max();
+                    for (size_t i = l; i < r; i++) {
+                        sum += a[i];
+                        hi = max(hi, a[i]);
+                        lo = min(lo, a[i]);
+                    }
+                    ok &= st.query(l, r) == sum && mx.query(l, r) == hi && ls.query(l, r) == sum &&
+                          lm.query(l, r) == lo && fw.rangeSum(l, r) == sum;
+                    int64_t target = static_cast<int64_t>(rng() % (fw.prefix(n) + 2));
+                    size_t k = 0;
+                    for (int64_t s = 0; k < n && s + a[k] < target; k++) s += a[k];
+                    ok &= fw.lowerBound(target) == (target <= 0 ? 0 : k);
+                }
+                }
+            }
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark against recursive trees
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoull(argv[1]) : 10'000'000;
+        const size_t q = 5'000'000;
+        cout << "Section C: Benchmark, n = " << n << ", " << q << " updates + " << q << " queries (ms)\n";
+        mt19937_64 rng(8);
+        vector<int64_t> a(n);
+        for (auto& x : a) x = static_cast<int64_t>(rng() % 1000);
+        struct Op { size_t l, r; int64_t v; };
+        vector<Op> ops(q);
+        for (auto& o : ops) {
+            o.l = rng() % n;
+            o.r = rng() % n;
+            if (o.l > o.r) swap(o.l, o.r);
+            o.r++;
+            o.v = static_cast<int64_t>(rng() % 1000);
+        }
+        volatile int64_t sink = 0;
+
+        {
+            double b1 = 0, b2 = 0, u1, u2, q1, q2;
+            {
+                RecursiveSumTree* rt = nullptr;
+                b2 = timeMs([&] { rt = new RecursiveSumTree(a); });
+                u2 = timeMs([&] { for (auto& o : ops) rt->set(o.l, o.v); });
+                q2 = timeMs([&] { int64_t s = 0; for (auto& o : ops) s += rt->query(o.l, o.r); sink = s; });
+                delete rt;
+            }
+            {
+                SegTree<SumMonoid<int64_t>>* st = nullptr;
+                b1 = timeMs([&] { st = new SegTree<SumMonoid<int64_t>>(a); });
+                u1 = timeMs([&] { for (auto& o : ops) st->set(o.l, o.v); });
+                q1 = timeMs([&] { int64_t s = 0; for (auto& o : ops) s += st->query(o.l, o.r); sink = s; });
+                delete st;
+            }
+            cout << "  point set / range sum   build " << b1 << " vs " << b2 << ", set " << u1 << " vs " << u2
+                 << ", query " << q1 << " vs " << q2 << "  (iterative vs recursive)\n";
+        }
+        {
+            double u1, u2, q1, q2;
+            {
+                RecursiveLazySumTree rt(a);
+                u2 = timeMs([&] { for (auto& o : ops) rt.add(o.l, o.r, o.v); });
+                q2 = timeMs([&] { int64_t s = 0; for (auto& o : ops) s ^= rt.query(o.l, o.r); sink = s; });
+            }
+            {
+                LazySegTree<AddToSum<int64_t>> lz(a);
+                u1 = timeMs([&] { for (auto& o : ops) lz.apply(o.l, o.r, o.v); });
+                q1 = timeMs([&] { int64_t s = 0; for (auto& o : ops) s ^= lz.query(o.l, o.r); sink = s; });
+            }
+            cout << "  range add / range sum   add " << u1 << " vs " << u2 << ", query " << q1 << " vs " << q2
+                 << "  (iterative lazy vs recursive lazy)\n";
+        }
+        {
+            double b1, b2, p1, l1, l2;
+            vector<int64_t> targets(q);
+            {
+                Fenwick<int64_t>* fw = nullptr;
+                b1 = timeMs([&] { fw = new Fenwick<int64_t>(a); });
+                for (auto& t : targets) t = static_cast<int64_t>(rng() % uint64_t(fw->prefix(n)));
+                p1 = timeMs([&] { int64_t s = 0; for (auto& o : ops) s += fw->prefix(o.r); sink = s; });
+                l1 = timeMs([&] { size_t s = 0; for (auto t : targets) s += fw->lowerBound(t); sink = int64_t(s); });
+                delete fw;
+            }
+            {
+                Fenwick<int64_t> fw(n);
+                b2 = timeMs([&] { for (size_t i = 0; i < n; i++) fw.add(i, a[i]); });
+                l2 = timeMs([&] {
+                    size_t s = 0;
+                    for (auto t : targets) {   // binary search over prefix(): O(log^2 n)
+                        size_t lo = 0, hi = n;
+                        while (lo < hi) {
+                            size_t mid = (lo + hi) / 2;
+                            if (fw.prefix(mid + 1) < t) lo = mid + 1;
+                            else                        hi = mid;
+                        }
+                        s += lo;
+                    }
+                    sink = int64_t(s);
+                });
+            }
+            cout << "  fenwick                 build " << b1 << " vs " << b2 << " (O(n) vs n adds), prefix " << p1
+                 << ", lowerBound " << l1 << " vs " << l2 << " (descent vs binary search)\n";
+        }
+    }
+
+    return 0;
+}
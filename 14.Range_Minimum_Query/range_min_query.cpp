@@ -0,0 +1,349 @@
+/*
+   ----------------------------------------------------------------------------
+   O(1) Range-Minimum Query
+   (Sparse Table, and Block Decomposition with In-Block Bitmask Stacks)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - A static array (like std::array in stl_array1.cpp) is queried for
+       min(a[l .. r)) many times. Both structures answer in O(1) with no
+       branches that depend on the data.
+     - SparseTable<T>: level k holds the minimum of every window of 2^k
+       elements. A query covers [l, r) with two overlapping windows of the
+       largest power of two that fits:
+           k = floor(log2(r - l)),  min(level[k][l], level[k][r - 2^k])
+       Memory: n * (floor(log2 n) + 1) values. For 10^8 int64 values that is
+       about 21 GB, which is the reason for the second structure.
+     - BlockRMQ<T>: the array is cut into blocks of 32.
+         * Across blocks: a SparseTable over the n / 32 block minima.
+         * Inside a block: for every position i a 32-bit mask of the
+           monotonic stack built while scanning the block up to i (bit j is
+           set if a[j] is the minimum of a[j .. i]). The minimum of a[l .. i]
+           within a block is then the lowest set bit of the mask at i at or
+           above l:
+               j = ctz(mask[i] & (~0u << (l % 32)))
+         A query is one in-block lookup at each end plus one sparse-table
+         lookup for the blocks in between.
+       Memory: 4 bytes of mask per element + a sparse table that is
+       log2(n/32) / 32 values per element, i.e. O(n); on top of the array
+       itself, which it references and does not copy.
+     - Equal values: the leftmost minimum is kept, so ties are stable.
+     - Batch queries: queries are processed in groups of BatchGroup; the
+       cache lines the group will read are prefetched before any of them is
+       used, so the misses of the whole group overlap. BlockRMQ does this in
+       two rounds because the masks decide which array elements are read.
+     - Measured with 2^23 random int64 and random ranges: the sparse table
+       needs 1.4 GB and answers in ~50 ns; BlockRMQ needs 66 MB (about the
+       size of the array) and answers in ~130-140 ns, since a query touches
+       up to six cache lines instead of two.
+
+   Functions (with Complexity):
+
+     SparseTable<T>(values)            O(n log n) time and memory
+     BlockRMQ<T>(values)               O(n) time and memory; keeps a reference
+                                       to values, which must outlive it
+     query(l, r)                       min of [l, r), O(1); an empty or
+                                       out-of-range [l, r) throws
+                                       std::out_of_range
+     queryBatch(ranges, out)           out[i] = query(ranges[i]), prefetched
+     bytes()                           memory used by the structure
+
+   Compile:
+       g++ -std=c++17 -O2 range_min_query.cpp -o range_min_query
+   Run:
+       ./range_min_query [n]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::min, std::min_element
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For int64_t, uint32_t
+#include <limits>      // For std::numeric_limits
+#include <random>      // For test data
+#include <stdexcept>   // For std::out_of_range
+#include <string>      // For std::stoull
+#include <utility>     // For std::pair
+
+using namespace std;
+
+using RangeQuery = pair<size_t, size_t>;   // half-open [first, second)
+
+constexpr size_t BatchGroup = 32;
+
+inline unsigned floorLog2(size_t x) { return 63 - static_cast<unsigned>(__builtin_clzll(x)); }
+
+inline void checkQuery(size_t l, size_t r, size_t n, const char* what) {
+    if (l >= r || r > n) throw out_of_range(what);
+}
+
+// ---------------------------------------------------------
+// SparseTable
+// ---------------------------------------------------------
+
+template <typename T>
+class SparseTable {
+public:
+    SparseTable() = default;
+
+    explicit SparseTable(const vector<T>& a) : n_(a.size()) {
+        if (n_ == 0) return;
+        unsigned levels = floorLog2(n_) + 1;
+        offset_.resize(levels);
+        size_t total = 0;
+        for (unsigned k = 0; k < levels; k++) {
+            offset_[k] = total;
+            total += n_ - (size_t(1) << k) + 1;
+        }
+        t_.resize(total);
+        copy(a.begin(), a.end(), t_.begin());
+        for (unsigned k = 1; k < levels; k++) {
+            const T* prev = &t_[offset_[k - 1]];
+            T* cur = &t_[offset_[k]];
+            size_t half = size_t(1) << (k - 1), len = n_ - (size_t(1) << k) + 1;
+            for (size_t i = 0; i < len; i++) cur[i] = min(prev[i], prev[i + half]);
+        }
+    }
+
+    size_t size() const { return n_; }
+    size_t bytes() const { return t_.size() * sizeof(T) + offset_.size() * sizeof(size_t); }
+
+    T query(size_t l, size_t r) const {
+        checkQuery(l, r, n_, "SparseTable::query");
+        return queryUnchecked(l, r);
+    }
+
+    T queryUnchecked(size_t l, size_t r) const {
+        unsigned k = floorLog2(r - l);
+        const T* row = &t_[offset_[k]];
+        return min(row[l], row[r - (size_t(1) << k)]);
+    }
+
+    void prefetch(size_t l, size_t r) const {
+        unsigned k = floorLog2(r - l);
+        const T* row = &t_[offset_[k]];
+        __builtin_prefetch(row + l);
+        __builtin_prefetch(row + r - (size_t(1) << k));
+    }
+
+    void queryBatch(const vector<RangeQuery>& qs, vector<T>& out) const {
+        for (const auto& q : qs) checkQuery(q.first, q.second, n_, "SparseTable::queryBatch");
+        out.resize(qs.size());
+        for (size_t g = 0; g < qs.size(); g += BatchGroup) {
+            size_t end = min(qs.size(), g + BatchGroup);
+            for (size_t i = g; i < end; i++) prefetch(qs[i].first, qs[i].second);
+            for (size_t i = g; i < end; i++) out[i] = queryUnchecked(qs[i].first, qs[i].second);
+        }
+    }
+
+private:
+    size_t n_ = 0;
+    vector<T> t_;               // all levels back to back
+    vector<size_t> offset_;     // start of level k in t_
+};
+
+// ---------------------------------------------------------
+// BlockRMQ
+// ---------------------------------------------------------
+
+template <typename T>
+class BlockRMQ {
+public:
+    static constexpr size_t Block = 32;
+
+    explicit BlockRMQ(const vector<T>& a) : a_(a), mask_(a.size()) {
+        size_t blocks = (a.size() + Block - 1) / Block;
+        vector<T> blockMin(blocks);
+        for (size_t b = 0; b < blocks; b++) {
+            size_t base = b * Block, end = min(a.size(), base + Block);
+            uint32_t stack = 0;
+            for (size_t i = base; i < end; i++) {
+                // Pop every candidate strictly greater than a[i]; equal ones
+                // stay so the leftmost minimum wins.
+                while (stack && a[base + 31 - __builtin_clz(stack)] > a[i])
+                    stack ^= uint32_t(1) << (31 - __builtin_clz(stack));
+                stack |= uint32_t(1) << (i - base);
+                mask_[i] = stack;
+            }
+            blockMin[b] = a[base + __builtin_ctz(mask_[end - 1])];
+        }
+        blocks_ = SparseTable<T>(blockMin);
+    }
+
+    size_t size() const { return a_.size(); }
+    size_t bytes() const { return mask_.size() * sizeof(uint32_t) + blocks_.bytes(); }
+
+    T query(size_t l, size_t r) const {
+        checkQuery(l, r, a_.size(), "BlockRMQ::query");
+        return queryUnchecked(l, r);
+    }
+
+    T queryUnchecked(size_t l, size_t r) const {
+        size_t last = r - 1;
+        size_t bl = l / Block, br = last / Block;
+        if (bl == br) return inBlock(l, last);
+        T m = min(inBlock(l, bl * Block + Block - 1), inBlock(br * Block, last));
+        if (bl + 1 < br) m = min(m, blocks_.queryUnchecked(bl + 1, br));
+        return m;
+    }
+
+    void queryBatch(const vector<RangeQuery>& qs, vector<T>& out) const {
+        for (const auto& q : qs) checkQuery(q.first, q.second, a_.size(), "BlockRMQ::queryBatch");
+        out.resize(qs.size());
+        size_t left[BatchGroup], right[BatchGroup];
+        for (size_t g = 0; g < qs.size(); g += BatchGroup) {
+            size_t cnt = min(BatchGroup, qs.size() - g);
+            const RangeQuery* q = &qs[g];
+            // Three passes so each one's misses overlap across the group:
+            // the two end masks and the sparse-table cells, then the array
+            // elements the masks point at, then the answers.
+            for (size_t i = 0; i < cnt; i++) {
+                size_t l = q[i].first, last = q[i].second - 1;
+                size_t bl = l / Block, br = last / Block;
+                __builtin_prefetch(&mask_[bl == br ? last : l | (Block - 1)]);
+                __builtin_prefetch(&mask_[last]);
+                if (bl + 1 < br) blocks_.prefetch(bl + 1, br);
+            }
+            for (size_t i = 0; i < cnt; i++) {
+                size_t l = q[i].first, last = q[i].second - 1;
+                bool same = l / Block == last / Block;
+                left[i] = inBlockIndex(l, same ? last : l | (Block - 1));
+                right[i] = inBlockIndex(same ? l : last & ~(Block - 1), last);
+                __builtin_prefetch(&a_[left[i]]);
+                __builtin_prefetch(&a_[right[i]]);
+            }
+            for (size_t i = 0; i < cnt; i++) {
+                size_t bl = q[i].first / Block, br = (q[i].second - 1) / Block;
+                T m = min(a_[left[i]], a_[right[i]]);
+                if (bl + 1 < br) m = min(m, blocks_.queryUnchecked(bl + 1, br));
+                out[g + i] = m;
+            }
+        }
+    }
+
+private:
+    // Index of the (leftmost) min of a[l .. i], both in the same block.
+    size_t inBlockIndex(size_t l, size_t i) const {
+        uint32_t m = mask_[i] & (~uint32_t(0) << (l % Block));
+        return (i & ~(Block - 1)) + __builtin_ctz(m);
+    }
+    T inBlock(size_t l, size_t i) const { return a_[inBlockIndex(l, i)]; }
+
+    const vector<T>& a_;
+    vector<uint32_t> mask_;
+    SparseTable<T> blocks_;
+};
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double bestNs(size_t ops, F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < 3; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, nano>(t1 - t0).count() / static_cast<double>(ops));
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        vector<int64_t> a = { 5, 2, 8, 6, 3, 7, 1, 9, 4 };
+        SparseTable<int64_t> st(a);
+        BlockRMQ<int64_t> br(a);
+        cout << "min[0, 4) = " << st.query(0, 4) << " / " << br.query(0, 4) << "\n";   // 2
+        cout << "min[2, 6) = " << st.query(2, 6) << " / " << br.query(2, 6) << "\n";   // 3
+        vector<int64_t> out;
+        br.queryBatch({ { 0, 9 }, { 7, 9 }, { 3, 4 } }, out);
+        cout << "batch:";
+        for (auto x : out) cout << " " << x;   // 1 4 6
+        cout << "\n";
+        try {
+            br.query(4, 4);
+        } catch (const out_of_range& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against a linear scan
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        mt19937_64 rng(3);
+        bool ok = true;
+        for (size_t n : { 1, 2, 31, 32, 33, 64, 100, 1000, 5000 }) {
+            for (int range : { 3, 1000000 }) {   // many ties / few ties
+                vector<int64_t> a(n);
+                for (auto& x : a) x = static_cast<int64_t>(rng() % range);
+                SparseTable<int64_t> st(a);
+                BlockRMQ<int64_t> br(a);
+                vector<RangeQuery> qs;
+                for (int t = 0; t < 2000; t++) {
+                    size_t l = rng() % n, r = rng() % n;
+                    if (l > r) swap(l, r);
+                    qs.push_back({ l, r + 1 });
+                }
+                vector<int64_t> o1, o2;
+                st.queryBatch(qs, o1);
+                br.queryBatch(qs, o2);
+                for (size_t i = 0; i < qs.size(); i++) {
+                    int64_t m = *min_element(a.begin() + qs[i].first, a.begin() + qs[i].second);
+                    ok &= st.query(qs[i].first, qs[i].second) == m && br.query(qs[i].first, qs[i].second) == m &&
+                          o1[i] == m && o2[i] == m;
+                }
+            }
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Memory and latency
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoull(argv[1]) : (size_t(1) << 23);
+        const size_t q = 5'000'000;
+        cout << "Section C: Benchmark, n = " << n << " int64, " << q << " random queries\n";
+        mt19937_64 rng(5);
+        vector<int64_t> a(n);
+        for (auto& x : a) x = static_cast<int64_t>(rng());
+        vector<RangeQuery> qs(q);
+        for (auto& r : qs) {
+            size_t l = rng() % n, h = rng() % n;
+            if (l > h) swap(l, h);
+            r = { l, h + 1 };
+        }
+        volatile int64_t sink = 0;
+        vector<int64_t> out;
+        double mb = 1 << 20;
+        cout << "  array itself: " << n * sizeof(int64_t) / mb << " MB\n";
+
+        {
+            BlockRMQ<int64_t> br(a);
+            double t1 = bestNs(q, [&] { int64_t s = 0; for (auto& r : qs) s ^= br.query(r.first, r.second); sink = s; });
+            double t2 = bestNs(q, [&] { br.queryBatch(qs, out); });
+            cout << "  BlockRMQ    : " << br.bytes() / mb << " MB extra, " << t1 << " ns/query, batch " << t2
+                 << " ns/query\n";
+        }
+        {
+            SparseTable<int64_t> st(a);
+            double t1 = bestNs(q, [&] { int64_t s = 0; for (auto& r : qs) s ^= st.query(r.first, r.second); sink = s; });
+            double t2 = bestNs(q, [&] { st.queryBatch(qs, out); });
+            cout << "  SparseTable : " << st.bytes() / mb << " MB extra, " << t1 << " ns/query, batch " << t2
+                 << " ns/query\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,396 @@
+/*
+   ----------------------------------------------------------------------------
+   Cache-Friendly Disjoint-Set Union (Union-Find)
+   (Packed Parent/Size Array, Path Halving, Batched Unions, Lock-Free CAS DSU)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - The textbook DSU keeps two vector<int>s, parent[] and rank[], so every
+       step of a find or union touches two cache lines per element. DSU here
+       keeps ONE int32 per element (the same contiguous storage as the
+       vector<int> of stl_vector.cpp):
+           p[x] >= 0 : parent of x
+           p[x] <  0 : x is a root and -p[x] is the size of its set
+       so the parent and the "rank" (size) of a root share one slot.
+     - Union by size keeps trees O(log n) deep; path halving (point every
+       visited node at its grandparent) flattens them further in the same
+       single pass, without recursion or a second walk.
+     - uniteAll(edges) prefetches the slots of edges a few positions ahead,
+       so the cache misses of independent unions overlap.
+     - ConcurrentDSU is lock-free: one atomic<uint32_t> parent per element.
+         find : path halving where each shortcut is a CAS that may fail
+                harmlessly (another thread already moved the node).
+         unite: find both roots, then CAS the root of lower priority from
+                "points to itself" to "points to the other root"; if the CAS
+                fails someone linked it first, so retry from the finds.
+       Priorities are a fixed pseudo-random permutation of the ids
+       (randomized linking by index), which gives the same expected depth as
+       union by size without storing or updating a size under concurrency.
+
+   Functions (with Complexity, alpha = inverse Ackermann):
+
+     DSU(n) / ConcurrentDSU(n)          n singletons, O(n). n must fit in 31
+                                        bits, else std::invalid_argument
+     find(x)                            root of x, amortised O(alpha(n))
+     unite(a, b)                        true if a and b were in different
+                                        sets, amortised O(alpha(n))
+     same(a, b)                         O(alpha(n))
+     setSize(x), components()           DSU: O(alpha(n)) / O(1)
+     uniteAll(edges)                    number of successful unions
+     ConcurrentDSU::components()        O(n); call when no thread is writing
+
+     Ids >= n throw std::out_of_range.
+
+   Compile:
+       g++ -std=c++17 -O2 -pthread dsu.cpp -o dsu
+   Run:
+       ./dsu [elements] [unions]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::swap
+#include <atomic>      // For std::atomic
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For int32_t, uint32_t, uint64_t
+#include <limits>      // For std::numeric_limits
+#include <random>      // For test data
+#include <stdexcept>   // For std::invalid_argument, std::out_of_range
+#include <string>      // For std::stoull
+#include <thread>      // For std::thread
+#include <utility>     // For std::pair
+
+using namespace std;
+
+using Edge = pair<uint32_t, uint32_t>;
+
+inline void checkCapacity(size_t n, const char* what) {
+    if (n > size_t(numeric_limits<int32_t>::max())) throw invalid_argument(what);
+}
+
+// ---------------------------------------------------------
+// DSU: parent and size packed in one int32 per element
+// ---------------------------------------------------------
+
+class DSU {
+public:
+    static constexpr size_t Lookahead = 8;   // edges prefetched ahead in uniteAll
+
+    explicit DSU(size_t n) : p_((checkCapacity(n, "DSU: too many elements"), n), -1), comps_(n) {}
+
+    size_t size() const { return p_.size(); }
+    size_t components() const { return comps_; }
+
+    uint32_t find(uint32_t x) {
+        check(x);
+        return root(x);
+    }
+
+    bool unite(uint32_t a, uint32_t b) {
+        check(a);
+        check(b);
+        return link(root(a), root(b));
+    }
+
+    bool same(uint32_t a, uint32_t b) {
+        check(a);
+        check(b);
+        return root(a) == root(b);
+    }
+
+    size_t setSize(uint32_t x) { return static_cast<size_t>(-p_[find(x)]); }
+
+    size_t uniteAll(const vector<Edge>& edges) {
+        for (const Edge& e : edges) {
+            check(e.first);
+            check(e.second);
+        }
+        size_t merged = 0;
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (i + Lookahead < edges.size()) {
+                __builtin_prefetch(&p_[edges[i + Lookahead].first], 1);
+                __builtin_prefetch(&p_[edges[i + Lookahead].second], 1);
+            }
+            merged += link(root(edges[i].first), root(edges[i].second));
+        }
+        return merged;
+    }
+
+private:
+    void check(uint32_t x) const {
+        if (x >= p_.size()) throw out_of_range("DSU: id out of range");
+    }
+
+    uint32_t root(uint32_t x) {
+        // Path halving: x jumps to its grandparent at every step.
+        while (true) {
+            int32_t parent = p_[x];
+            if (parent < 0) return x;
+            int32_t grand = p_[parent];
+            if (grand < 0) return static_cast<uint32_t>(parent);
+            p_[x] = grand;
+            x = static_cast<uint32_t>(grand);
+        }
+    }
+
+    bool link(uint32_t a, uint32_t b) {
+        if (a == b) return false;
+        if (p_[a] > p_[b]) swap(a, b);   // a is the larger set (more negative)
+        p_[a] += p_[b];
+        p_[b] = static_cast<int32_t>(a);
+        comps_--;
+        return true;
+    }
+
+    vector<int32_t> p_;
+    size_t comps_;
+};
+
+// ---------------------------------------------------------
+// ConcurrentDSU: lock-free, CAS on parent pointers
+// ---------------------------------------------------------
+
+class ConcurrentDSU {
+public:
+    explicit ConcurrentDSU(size_t n) : p_((checkCapacity(n, "ConcurrentDSU: too many elements"), n)) {
+        for (size_t i = 0; i < n; i++) p_[i].store(static_cast<uint32_t>(i), memory_order_relaxed);
+    }
+
+    size_t size() const { return p_.size(); }
+
+    uint32_t find(uint32_t x) {
+        check(x);
+        return root(x);
+    }
+
+    bool unite(uint32_t a, uint32_t b) {
+        check(a);
+        check(b);
+        while (true) {
+            a = root(a);
+            b = root(b);
+            if (a == b) return false;
+            if (priority(a) < priority(b)) swap(a, b);
+            uint32_t expected = b;   // b must still be a root
+            if (p_[b].compare_exchange_strong(expected, a, memory_order_acq_rel)) return true;
+        }
+    }
+
+    bool same(uint32_t a, uint32_t b) {
+        check(a);
+        check(b);
+        while (true) {
+            a = root(a);
+            b = root(b);
+            if (a == b) return true;
+            // a is still a root, so at this instant the sets are different.
+            if (p_[a].load(memory_order_acquire) == a) return false;
+        }
+    }
+
+    size_t components() const {
+        size_t c = 0;
+        for (size_t i = 0; i < p_.size(); i++) c += p_[i].load(memory_order_relaxed) == i;
+        return c;
+    }
+
+private:
+    void check(uint32_t x) const {
+        if (x >= p_.size()) throw out_of_range("ConcurrentDSU: id out of range");
+    }
+
+    // A bijective mix of the id, so every pair of roots has a strict order.
+    static uint32_t priority(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        return x ^ (x >> 16);
+    }
+
+    uint32_t root(uint32_t x) {
+        while (true) {
+            uint32_t parent = p_[x].load(memory_order_acquire);
+            if (parent == x) return x;
+            uint32_t grand = p_[parent].load(memory_order_acquire);
+            if (grand == parent) return parent;
+            // Shortcut; losing the race only means someone else moved x.
+            p_[x].compare_exchange_weak(parent, grand, memory_order_relaxed);
+            x = grand;
+        }
+    }
+
+    vector<atomic<uint32_t>> p_;
+};
+
+// ---------------------------------------------------------
+// Baseline: separate parent / rank arrays, recursive path compression
+// ---------------------------------------------------------
+
+struct TextbookDSU {
+    vector<int> parent, rank;
+
+    explicit TextbookDSU(size_t n) : parent(n), rank(n, 0) {
+        for (size_t i = 0; i < n; i++) parent[i] = static_cast<int>(i);
+    }
+    int find(int x) { return parent[x] == x ? x : parent[x] = find(parent[x]); }
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+        return true;
+    }
+};
+
+// ---------------------------------------------------------
+// Benchmark helpers
+// ---------------------------------------------------------
+
+// The same random edge stream for every structure, produced in chunks so
+// 10^8 unions never need 800 MB of edges at once.
+template <typename F>
+void forEachEdgeChunk(size_t n, size_t unions, uint64_t seed, F&& f) {
+    const size_t chunk = 1 << 20;
+    mt19937_64 rng(seed);
+    vector<Edge> edges;
+    for (size_t done = 0; done < unions; done += chunk) {
+        edges.resize(min(chunk, unions - done));
+        for (auto& e : edges) {
+            uint64_t r = rng();
+            e = { static_cast<uint32_t>((r >> 32) % n), static_cast<uint32_t>((r & 0xFFFFFFFFu) % n) };
+        }
+        f(edges);
+    }
+}
+
+template <typename F>
+double timeSec(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        DSU d(6);
+        d.unite(0, 1);
+        d.unite(2, 3);
+        d.unite(1, 3);
+        cout << "same(0, 2) = " << d.same(0, 2) << ", same(0, 4) = " << d.same(0, 4) << "\n";   // 1, 0
+        cout << "setSize(3) = " << d.setSize(3) << ", components = " << d.components() << "\n"; // 4, 3
+        try {
+            d.unite(0, 6);
+        } catch (const out_of_range& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check (sequential and 4 threads)
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        bool ok = true;
+        for (size_t n : { 1, 10, 1000, 100000 }) {
+            size_t unions = n;
+            DSU a(n), b(n);
+            TextbookDSU ref(n);
+            ConcurrentDSU c(n);
+            vector<Edge> all;
+            forEachEdgeChunk(n, unions, n, [&](const vector<Edge>& edges) {
+                for (const Edge& e : edges) {
+                    bool r = ref.unite(static_cast<int>(e.first), static_cast<int>(e.second));
+                    ok &= a.unite(e.first, e.second) == r;
+                }
+                b.uniteAll(edges);
+                all.insert(all.end(), edges.begin(), edges.end());
+            });
+            vector<thread> ts;
+            for (size_t t = 0; t < 4; t++)
+                ts.emplace_back([&, t] {
+                    for (size_t i = t; i < all.size(); i += 4) c.unite(all[i].first, all[i].second);
+                });
+            for (auto& t : ts) t.join();
+            for (uint32_t x = 0; x < n; x++) {
+                uint32_t y = static_cast<uint32_t>((x * 7919ULL) % n);
+                bool r = ref.find(static_cast<int>(x)) == ref.find(static_cast<int>(y));
+                ok &= a.same(x, y) == r && b.same(x, y) == r && c.same(x, y) == r;
+            }
+            ok &= a.components() == b.components() && c.components() == a.components();
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoull(argv[1]) : 100'000'000;
+        size_t unions = argc > 2 ? stoull(argv[2]) : 100'000'000;
+        cout << "Section C: Benchmark, " << n << " elements, " << unions << " random unions (s)\n";
+
+        double genOnly = timeSec([&] { forEachEdgeChunk(n, unions, 1, [](const vector<Edge>&) {}); });
+        cout << "  (edge generation alone: " << genOnly << ", included below)\n";
+        {
+            TextbookDSU d(n);
+            double t = timeSec([&] {
+                forEachEdgeChunk(n, unions, 1, [&](const vector<Edge>& es) {
+                    for (const Edge& e : es) d.unite(static_cast<int>(e.first), static_cast<int>(e.second));
+                });
+            });
+            cout << "  textbook (parent[] + rank[], recursive): " << t << "\n";
+        }
+        size_t comps = 0;
+        {
+            DSU d(n);
+            double t = timeSec([&] {
+                forEachEdgeChunk(n, unions, 1, [&](const vector<Edge>& es) {
+                    for (const Edge& e : es) d.unite(e.first, e.second);
+                });
+            });
+            cout << "  packed, path halving                  : " << t << "\n";
+        }
+        {
+            DSU d(n);
+            double t = timeSec([&] {
+                forEachEdgeChunk(n, unions, 1, [&](const vector<Edge>& es) { d.uniteAll(es); });
+            });
+            comps = d.components();
+            cout << "  packed, uniteAll with prefetch        : " << t << "  (" << comps << " components)\n";
+        }
+
+        // Threads split each chunk as it is generated; only the unions (and
+        // starting the threads per chunk) are timed, not the generation.
+        size_t hw = max(1u, thread::hardware_concurrency());
+        for (size_t threads = 1; threads <= hw; threads *= 2) {
+            ConcurrentDSU d(n);
+            double t = 0;
+            forEachEdgeChunk(n, unions, 1, [&](const vector<Edge>& es) {
+                t += timeSec([&] {
+                    vector<thread> ts;
+                    for (size_t k = 0; k < threads; k++)
+                        ts.emplace_back([&, k] {
+                            size_t lo = es.size() * k / threads, hi = es.size() * (k + 1) / threads;
+                            for (size_t i = lo; i < hi; i++) d.unite(es[i].first, es[i].second);
+                        });
+                    for (auto& th : ts) th.join();
+                });
+            });
+            cout << "  lock-free CAS, " << threads << " thread(s)            : " << t
+                 << (d.components() == comps ? "" : "  (component count MISMATCH)") << "\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*
+   ----------------------------------------------------------------------------
+   Modular Integers with Montgomery and Barrett Reduction
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - a * b % m compiles to a 64-bit division (20-90 cycles) unless m is a
+       compile-time constant. Both reductions below replace it with
+       multiplications:
+         Montgomery (odd m < 2^30): values are kept as x * 2^32 mod m.
+             reduce(t) = (t + ((uint32)t * -m^-1 mod 2^32) * m) >> 32
+           is t * 2^-32 mod m in [0, 2m): two 32x32 multiplies, one shift.
+         Barrett (any 1 <= m < 2^32): with im = floor((2^64 - 1) / m) + 1,
+             q = high64(t * im),  t - q * m  is t mod m, or t mod m - m
+           (fixed by one conditional add).
+     - Montgomery32        runtime or constexpr Montgomery parameters.
+       Barrett32           runtime Barrett parameters.
+     - ModInt<Mod>         compile-time modulus, Montgomery form inside.
+       DynModInt<Id>       runtime modulus shared by all values with the same
+                           Id (set with DynModInt<Id>::setModulus), Barrett.
+       Both support + - * / += -= *= /= == != pow() inv() val() and <<.
+       inv() and / use Fermat's little theorem and need a prime modulus.
+     - Batch kernels over arrays of plain values in [0, m):
+         mulMod(a, b, out, n, mont)   out[i] = a[i] * b[i] mod m
+         addMod(a, b, out, n, m)      out[i] = a[i] + b[i] mod m
+       The AVX2 versions do 8 Montgomery products at once with vpmuludq on
+       the even and odd lanes; the CPU is checked once at run time.
+     - avx2::montMul / avx2::reduceOnce are exposed for other kernels (NTT)
+       that keep data in Montgomery form.
+
+   ----------------------------------------------------------------------------
+*/
+
+#ifndef MODINT_H
+#define MODINT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MODINT_X86 1
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------
+// Montgomery32 / Barrett32
+// ---------------------------------------------------------
+
+struct Montgomery32 {
+    uint32_t mod;
+    uint32_t nInv;   // -mod^-1 mod 2^32
+    uint32_t r2;     // 2^64 mod mod
+
+    constexpr explicit Montgomery32(uint32_t m) : mod(m), nInv(0), r2(0) {
+        if (m % 2 == 0 || m >= (uint32_t(1) << 30))
+            throw std::invalid_argument("Montgomery32: modulus must be odd and < 2^30");
+        uint32_t inv = m;   // Newton: each step doubles the correct low bits
+        for (int i = 0; i < 5; i++) inv *= 2 - m * inv;
+        nInv = 0 - inv;
+        r2 = static_cast<uint32_t>((0 - static_cast<uint64_t>(m)) % m);
+    }
+
+    // t < mod * 2^32  ->  t * 2^-32 mod m, in [0, 2 * mod)
+    constexpr uint32_t reduce(uint64_t t) const {
+        uint32_t q = static_cast<uint32_t>(t) * nInv;
+        return static_cast<uint32_t>((t + static_cast<uint64_t>(q) * mod) >> 32);
+    }
+    // Branch-free: x - mod wraps to a huge value when x < mod.
+    constexpr uint32_t normalize(uint32_t x) const { return std::min(x, x - mod); }
+
+    // Inputs in [0, 2 * mod): lazy result in [0, 2 * mod), or canonical.
+    constexpr uint32_t mulLazy(uint32_t a, uint32_t b) const { return reduce(static_cast<uint64_t>(a) * b); }
+    constexpr uint32_t mul(uint32_t a, uint32_t b) const { return normalize(mulLazy(a, b)); }
+
+    constexpr uint32_t toMont(uint32_t x) const { return mul(x % mod, r2); }
+    constexpr uint32_t fromMont(uint32_t x) const { return normalize(reduce(x)); }
+};
+
+struct Barrett32 {
+    __extension__ typedef unsigned __int128 u128;   // GCC/Clang builtin; no -Wpedantic warning
+
+    uint32_t mod = 1;
+    uint64_t im = 0;   // floor((2^64 - 1) / mod) + 1, wraps to 0 for mod == 1
+
+    Barrett32() = default;
+    explicit Barrett32(uint32_t m) : mod(m), im(~uint64_t(0) / m + 1) {
+        if (m == 0) throw std::invalid_argument("Barrett32: modulus must be positive");
+    }
+
+    // a, b < mod
+    uint32_t mul(uint32_t a, uint32_t b) const {
+        uint64_t z = static_cast<uint64_t>(a) * b;
+        uint64_t q = static_cast<uint64_t>((static_cast<u128>(z) * im) >> 64);
+        uint64_t y = q * mod;
+        return static_cast<uint32_t>(z - y + (z < y ? mod : 0));
+    }
+};
+
+// ---------------------------------------------------------
+// ModInt<Mod>: compile-time modulus, Montgomery form
+// ---------------------------------------------------------
+
+template <uint32_t Mod>
+class ModInt {
+    static_assert(Mod % 2 == 1 && Mod < (uint32_t(1) << 30), "ModInt: modulus must be odd and < 2^30");
+    static constexpr Montgomery32 M{ Mod };
+
+public:
+    constexpr ModInt() : v_(0) {}
+    constexpr ModInt(int64_t x)
+        : v_(M.toMont(static_cast<uint32_t>(x % static_cast<int64_t>(Mod) + (x < 0 ? Mod : 0)))) {}
+
+    static constexpr uint32_t mod() { return Mod; }
+    static constexpr ModInt fromMontgomery(uint32_t raw) { ModInt r; r.v_ = raw; return r; }
+    constexpr uint32_t montgomery() const { return v_; }
+    constexpr uint32_t val() const { return M.fromMont(v_); }
+
+    constexpr ModInt& operator+=(ModInt o) { v_ = M.normalize(v_ + o.v_); return *this; }
+    constexpr ModInt& operator-=(ModInt o) { v_ = v_ >= o.v_ ? v_ - o.v_ : v_ + Mod - o.v_; return *this; }
+    constexpr ModInt& operator*=(ModInt o) { v_ = M.mul(v_, o.v_); return *this; }
+    constexpr ModInt& operator/=(ModInt o) { return *this *= o.inv(); }
+
+    friend constexpr ModInt operator+(ModInt a, ModInt b) { return a += b; }
+    friend constexpr ModInt operator-(ModInt a, ModInt b) { return a -= b; }
+    friend constexpr ModInt operator*(ModInt a, ModInt b) { return a *= b; }
+    friend constexpr ModInt operator/(ModInt a, ModInt b) { return a /= b; }
+    constexpr ModInt operator-() const { return ModInt() - *this; }
+    friend constexpr bool operator==(ModInt a, ModInt b) { return a.v_ == b.v_; }
+    friend constexpr bool operator!=(ModInt a, ModInt b) { return a.v_ != b.v_; }
+
+    constexpr ModInt pow(uint64_t e) const {
+        ModInt r(1), b = *this;
+        for (; e; e >>= 1, b *= b)
+            if (e & 1) r *= b;
+        return r;
+    }
+    constexpr ModInt inv() const {
+        if (v_ == 0) throw std::domain_error("ModInt: inverse of zero");
+        return pow(Mod - 2);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, ModInt x) { return os << x.val(); }
+
+private:
+    uint32_t v_;   // Montgomery form, canonical [0, Mod)
+};
+
+// ---------------------------------------------------------
+// DynModInt<Id>: runtime modulus, Barrett reduction
+// ---------------------------------------------------------
+
+template <int Id>
+class DynModInt {
+public:
+    static void setModulus(uint32_t m) { ctx() = Barrett32(m); }
+    static uint32_t mod() { return ctx().mod; }
+
+    DynModInt() : v_(0) {}
+    DynModInt(int64_t x) {
+        int64_t m = ctx().mod;
+        x %= m;
+        v_ = static_cast<uint32_t>(x < 0 ? x + m : x);
+    }
+
+    uint32_t val() const { return v_; }
+
+    DynModInt& operator+=(DynModInt o) { v_ += o.v_; if (v_ >= mod() || v_ < o.v_) v_ -= mod(); return *this; }
+    DynModInt& operator-=(DynModInt o) { v_ = v_ >= o.v_ ? v_ - o.v_ : v_ + (mod() - o.v_); return *this; }
+    DynModInt& operator*=(DynModInt o) { v_ = ctx().mul(v_, o.v_); return *this; }
+    DynModInt& operator/=(DynModInt o) { return *this *= o.inv(); }
+
+    friend DynModInt operator+(DynModInt a, DynModInt b) { return a += b; }
+    friend DynModInt operator-(DynModInt a, DynModInt b) { return a -= b; }
+    friend DynModInt operator*(DynModInt a, DynModInt b) { return a *= b; }
+    friend DynModInt operator/(DynModInt a, DynModInt b) { return a /= b; }
+    DynModInt operator-() const { return DynModInt() - *this; }
+    friend bool operator==(DynModInt a, DynModInt b) { return a.v_ == b.v_; }
+    friend bool operator!=(DynModInt a, DynModInt b) { return a.v_ != b.v_; }
+
+    DynModInt pow(uint64_t e) const {
+        DynModInt r(1), b = *this;
+        for (; e; e >>= 1, b *= b)
+            if (e & 1) r *= b;
+        return r;
+    }
+    DynModInt inv() const {
+        if (v_ == 0) throw std::domain_error("DynModInt: inverse of zero");
+        return pow(mod() - 2);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, DynModInt x) { return os << x.v_; }
+
+private:
+    static Barrett32& ctx() {
+        static Barrett32 b(998244353);
+        return b;
+    }
+
+    uint32_t v_;   // canonical [0, mod)
+};
+
+// ---------------------------------------------------------
+// Batch kernels
+// ---------------------------------------------------------
+
+#ifdef MODINT_X86
+namespace avx2 {
+
+// Montgomery product of 8 lanes; inputs < 2 * mod, result in [0, 2 * mod).
+__attribute__((target("avx2"))) inline __m256i montMul(__m256i a, __m256i b, __m256i mod, __m256i nInv) {
+    __m256i prodEven = _mm256_mul_epu32(a, b);
+    __m256i prodOdd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    __m256i qEven = _mm256_mul_epu32(prodEven, nInv);   // low 32 bits are q
+    __m256i qOdd = _mm256_mul_epu32(prodOdd, nInv);
+    __m256i tEven = _mm256_add_epi64(prodEven, _mm256_mul_epu32(qEven, mod));
+    __m256i tOdd = _mm256_add_epi64(prodOdd, _mm256_mul_epu32(qOdd, mod));
+    // The results are the high halves: shift the even ones down, keep the odd in place.
+    return _mm256_blend_epi32(_mm256_srli_epi64(tEven, 32), tOdd, 0xAA);
+}
+
+// [0, 2 * mod) -> [0, mod)
+__attribute__((target("avx2"))) inline __m256i reduceOnce(__m256i x, __m256i mod) {
+    return _mm256_min_epu32(x, _mm256_sub_epi32(x, mod));
+}
+
+__attribute__((target("avx2"))) inline void mulMod(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n,
+                                                   const Montgomery32& m) {
+    const __m256i mod = _mm256_set1_epi32(static_cast<int>(m.mod));
+    const __m256i nInv = _mm256_set1_epi32(static_cast<int>(m.nInv));
+    const __m256i r2 = _mm256_set1_epi32(static_cast<int>(m.r2));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        // (x * y * R^-1) * R^2 * R^-1 = x * y
+        __m256i p = montMul(montMul(x, y, mod, nInv), r2, mod, nInv);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), reduceOnce(p, mod));
+    }
+    for (; i < n; i++) out[i] = m.mul(m.mulLazy(a[i], b[i]), m.r2);
+}
+
+__attribute__((target("avx2"))) inline void addMod(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n,
+                                                   uint32_t m) {
+    const __m256i mod = _mm256_set1_epi32(static_cast<int>(m));
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), reduceOnce(s, mod));
+    }
+    for (; i < n; i++) out[i] = std::min(a[i] + b[i], a[i] + b[i] - m);
+}
+
+inline bool supported() {
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+}
+
+} // namespace avx2
+#endif
+
+// Scalar kernels: the same arithmetic one element at a time.
+inline void mulModScalar(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n, const Montgomery32& m) {
+    for (size_t i = 0; i < n; i++) out[i] = m.mul(m.mulLazy(a[i], b[i]), m.r2);
+}
+
+inline void addModScalar(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n, uint32_t m) {
+    for (size_t i = 0; i < n; i++) out[i] = std::min(a[i] + b[i], a[i] + b[i] - m);
+}
+
+// Dispatching entry points; inputs must already be in [0, m).
+inline void mulMod(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n, const Montgomery32& m) {
+#ifdef MODINT_X86
+    if (avx2::supported()) return avx2::mulMod(a, b, out, n, m);
+#endif
+    mulModScalar(a, b, out, n, m);
+}
+
+inline void addMod(const uint32_t* a, const uint32_t* b, uint32_t* out, size_t n, uint32_t m) {
+    if (m >= (uint32_t(1) << 31)) throw std::invalid_argument("addMod: modulus must be < 2^31");
+#ifdef MODINT_X86
+    if (avx2::supported()) return avx2::addMod(a, b, out, n, m);
+#endif
+    addModScalar(a, b, out, n, m);
+}
+
+#endif // MODINT_H
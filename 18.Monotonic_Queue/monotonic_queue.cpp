@@ -0,0 +1,488 @@
+/*
+   ----------------------------------------------------------------------------
+   Sliding-Window Minimum / Maximum and Aggregates in O(1) Amortized
+   (Ring-Buffer Monotonic Queue, Two-Stack Aggregate Queue, van Herk/Gil-Werman)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - The textbook sliding-window minimum keeps a std::deque (stl_intro.txt,
+       "Deque") of candidate positions whose values increase from front to
+       back: a new value first removes every candidate at the back that is
+       not smaller than it, the front leaves when it falls out of the
+       window, and the front is the answer. Each value enters and leaves
+       once, so O(1) amortized, but std::deque allocates a block every few
+       hundred elements and every push_back / pop_front checks block
+       boundaries.
+     - MonotonicQueue<T, Compare>: the same algorithm on a fixed ring of
+       2^k >= window slots, allocated once. The window holds the last
+       `window` pushed values; the oldest leaves automatically on push, or
+       explicitly with popFront() for windows defined by something else
+       (time stamps, ...). Every value carries its sequence number, so
+       popFront() is a compare and an add, no branch. pushBatch(span, out)
+       runs a whole span with the ring state in registers and writes the
+       window answer after every element.
+     - TwoStackQueue<Monoid>: a FIFO queue that answers
+       combine(front, ..., back) for any associative operation (min, gcd,
+       matrix or affine-map products, which are not commutative and have no
+       inverse). It is the classic queue-from-two-stacks in ONE ring buffer:
+         * back part [mid, tail): values plus one running aggregate.
+         * front part [head, mid): every slot also keeps the aggregate of
+           itself up to mid.
+         * pop with an empty front part re-labels the back part as the
+           front part, computing the suffix aggregates right to left in
+           place; no value is moved. Each value is combined O(1) times.
+     - slidingExtremes(data, n, w, out): when the whole array is known, the
+       van Herk/Gil-Werman method is branch-free: cut the array into blocks
+       of w; window [j, j + w) ends in the block after the one it starts
+       in, so its answer is best(suffix extreme of j's block from j,
+       prefix extreme of the next block up to j + w - 1). Suffixes go into
+       a w-slot buffer, the prefix is a running value: three comparisons
+       per element whatever the data, all of them conditional moves.
+     - Measured (10^7 random int32, 1-core Xeon VM, ns per element):
+           window   deque   multiset   Monotonic   batch   TwoStack   vHGW
+           16       19      170        20          19      17         3.0
+           1024     20      300        21          19      13         3.5
+           65536    20      1000       20          18      13         3.7
+       On random data the pop-back loop of a monotonic queue is an
+       unpredictable branch, and that, not std::deque's block bookkeeping,
+       sets the cost: the ring buffer only saves the deque's allocations.
+       The two-stack queue has no data-dependent branch (its rebuild runs
+       once per w pops) and beats both; vHGW, which needs the whole array,
+       is 5-6x faster than any queue.
+
+   Member Functions (with Complexity):
+
+     MonotonicQueue<T, Compare>(window)  O(window) memory; window 0 throws
+                                         std::invalid_argument
+     push(x)                             O(1) amortized; evicts the oldest
+                                         value when the window is full
+     pushBatch(data, n, out)             out[i] = front() after push(data[i])
+     popFront()                          O(1); empty queue throws
+                                         std::out_of_range
+     front()                             O(1) best value under Compare (min
+                                         for std::less); empty throws
+     size() / empty() / window()         O(1)
+
+     TwoStackQueue<Monoid>()             grows by doubling
+     push(x) / pop()                     O(1) amortized; pop on empty throws
+                                         std::out_of_range
+     query()                             O(1), Monoid::identity() when empty
+
+     slidingExtremes(data, n, w, out)    O(n), out[j] = best of data[j, j + w)
+                                         for j in [0, n - w]
+
+   Compile:
+       g++ -std=c++17 -O2 monotonic_queue.cpp -o monotonic_queue
+   Run:
+       ./monotonic_queue [n]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::min, std::max
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For uint64_t, int32_t
+#include <deque>       // For the textbook baseline
+#include <functional>  // For std::less, std::greater
+#include <limits>      // For std::numeric_limits
+#include <numeric>     // For std::gcd
+#include <random>      // For test data
+#include <set>         // For the multiset baseline
+#include <stdexcept>   // For std::invalid_argument, std::out_of_range
+#include <string>      // For std::stoull
+
+using namespace std;
+
+// ---------------------------------------------------------
+// MonotonicQueue: fixed ring, sequence-numbered entries
+// ---------------------------------------------------------
+
+template <typename T, typename Compare = less<T>>
+class MonotonicQueue {
+public:
+    explicit MonotonicQueue(size_t window, Compare comp = Compare()) : window_(window), comp_(comp) {
+        if (window == 0) throw invalid_argument("MonotonicQueue: window must be positive");
+        size_t cap = 1;
+        while (cap < window) cap *= 2;
+        mask_ = cap - 1;
+        vals_.resize(cap);
+        seqs_.resize(cap);
+    }
+
+    size_t window() const { return window_; }
+    size_t size() const { return pushed_ - expired_; }
+    bool empty() const { return pushed_ == expired_; }
+
+    const T& front() const {
+        if (empty()) throw out_of_range("MonotonicQueue: front of empty queue");
+        return vals_[head_ & mask_];
+    }
+
+    void push(const T& x) {
+        if (size() == window_) popFront();
+        while (tail_ != head_ && !comp_(vals_[(tail_ - 1) & mask_], x)) tail_--;
+        vals_[tail_ & mask_] = x;
+        seqs_[tail_ & mask_] = pushed_++;
+        tail_++;
+    }
+
+    // Removes the oldest value of the window; it is the front candidate
+    // only if nothing newer has displaced it.
+    void popFront() {
+        if (empty()) throw out_of_range("MonotonicQueue: popFront on empty queue");
+        head_ += seqs_[head_ & mask_] == expired_;
+        expired_++;
+    }
+
+    void pushBatch(const T* data, size_t n, T* out) {
+        size_t head = head_, tail = tail_;
+        uint64_t pushed = pushed_, expired = expired_;
+        const size_t mask = mask_;
+        T* vals = vals_.data();
+        uint64_t* seqs = seqs_.data();
+        for (size_t i = 0; i < n; i++) {
+            if (pushed - expired == window_) {
+                head += seqs[head & mask] == expired;
+                expired++;
+            }
+            const T x = data[i];
+            while (tail != head && !comp_(vals[(tail - 1) & mask], x)) tail--;
+            vals[tail & mask] = x;
+            seqs[tail & mask] = pushed++;
+            tail++;
+            out[i] = vals[head & mask];
+        }
+        head_ = head;
+        tail_ = tail;
+        pushed_ = pushed;
+        expired_ = expired;
+    }
+
+private:
+    size_t window_;
+    Compare comp_;
+    size_t mask_ = 0;
+    size_t head_ = 0, tail_ = 0;           // candidates live in ring slots [head_, tail_)
+    uint64_t pushed_ = 0, expired_ = 0;    // sequence numbers: window is [expired_, pushed_)
+    vector<T> vals_;
+    vector<uint64_t> seqs_;
+};
+
+// ---------------------------------------------------------
+// Monoids (same shape as 13.SegmentTree_Fenwick)
+// ---------------------------------------------------------
+
+template <typename T>
+struct MinMonoid {
+    using value_type = T;
+    static T identity() { return numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return min(a, b); }
+};
+
+template <typename T>
+struct GcdMonoid {
+    using value_type = T;
+    static T identity() { return T(0); }
+    static T combine(const T& a, const T& b) { return gcd(a, b); }
+};
+
+// x -> a * x + b (mod P); combine(f, g) applies f first, then g.
+struct AffineMonoid {
+    static constexpr uint64_t P = 998244353;
+    struct value_type { uint64_t a, b; };
+    static value_type identity() { return { 1, 0 }; }
+    static value_type combine(const value_type& f, const value_type& g) {
+        return { g.a * f.a % P, (g.a * f.b + g.b) % P };
+    }
+};
+
+// ---------------------------------------------------------
+// TwoStackQueue: both stacks share one ring buffer
+// ---------------------------------------------------------
+
+template <typename Monoid>
+class TwoStackQueue {
+public:
+    using T = typename Monoid::value_type;
+
+    TwoStackQueue() : vals_(16), aggs_(16), mask_(15), backAgg_(Monoid::identity()) {}
+
+    size_t size() const { return tail_ - head_; }
+    bool empty() const { return tail_ == head_; }
+
+    void push(const T& x) {
+        if (size() == vals_.size()) grow();
+        vals_[tail_ & mask_] = x;
+        tail_++;
+        backAgg_ = Monoid::combine(backAgg_, x);
+    }
+
+    void pop() {
+        if (empty()) throw out_of_range("TwoStackQueue: pop on empty queue");
+        if (head_ == mid_) flip();
+        head_++;
+    }
+
+    // combine(oldest, ..., newest)
+    T query() const {
+        if (head_ == mid_) return backAgg_;
+        return Monoid::combine(aggs_[head_ & mask_], backAgg_);
+    }
+
+private:
+    // The back part becomes the front part: suffix aggregates, right to left.
+    void flip() {
+        T acc = Monoid::identity();
+        for (size_t i = tail_; i-- > head_;) {
+            acc = Monoid::combine(vals_[i & mask_], acc);
+            aggs_[i & mask_] = acc;
+        }
+        mid_ = tail_;
+        backAgg_ = Monoid::identity();
+    }
+
+    void grow() {
+        size_t cap = vals_.size();
+        vector<T> vals(2 * cap), aggs(2 * cap);
+        for (size_t i = head_; i < tail_; i++) {
+            vals[i - head_] = vals_[i & mask_];
+            aggs[i - head_] = aggs_[i & mask_];
+        }
+        mid_ -= head_;
+        tail_ -= head_;
+        head_ = 0;
+        vals_.swap(vals);
+        aggs_.swap(aggs);
+        mask_ = 2 * cap - 1;
+    }
+
+    vector<T> vals_, aggs_;
+    size_t mask_;
+    size_t head_ = 0, mid_ = 0, tail_ = 0;   // front part [head_, mid_), back part [mid_, tail_)
+    T backAgg_;
+};
+
+// ---------------------------------------------------------
+// slidingExtremes: van Herk / Gil-Werman on a whole array
+// ---------------------------------------------------------
+
+template <typename T, typename Compare = less<T>>
+void slidingExtremes(const T* data, size_t n, size_t w, T* out, Compare comp = Compare()) {
+    if (w == 0) throw invalid_argument("slidingExtremes: window must be positive");
+    if (n < w) return;
+    auto best = [&](const T& a, const T& b) { return comp(b, a) ? b : a; };
+    // Windows starting in block [s, s + w) end in the next block: suffix
+    // extremes of this block (kept in a w-slot buffer) against the running
+    // prefix extreme of the next one.
+    vector<T> suffix(w);
+    for (size_t s = 0; s + w <= n; s += w) {
+        suffix[w - 1] = data[s + w - 1];
+        for (size_t i = w - 1; i-- > 0;) suffix[i] = best(data[s + i], suffix[i + 1]);
+        out[s] = suffix[0];
+        size_t last = min(s + w - 1, n - w);   // last window start in this block
+        if (last == s) continue;
+        T prefix = data[s + w];
+        out[s + 1] = best(suffix[1], prefix);
+        for (size_t j = s + 2; j <= last; j++) {
+            prefix = best(prefix, data[j + w - 1]);
+            out[j] = best(suffix[j - s], prefix);
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// Baselines
+// ---------------------------------------------------------
+
+// Textbook: std::deque of (position, value) candidates.
+template <typename T>
+void slidingMinDeque(const vector<T>& data, size_t w, vector<T>& out) {
+    deque<pair<size_t, T>> dq;
+    for (size_t i = 0; i < data.size(); i++) {
+        while (!dq.empty() && dq.back().second >= data[i]) dq.pop_back();
+        dq.emplace_back(i, data[i]);
+        if (dq.front().first + w <= i) dq.pop_front();
+        out[i] = dq.front().second;
+    }
+}
+
+template <typename T>
+void slidingMinMultiset(const vector<T>& data, size_t w, vector<T>& out) {
+    multiset<T> window;
+    for (size_t i = 0; i < data.size(); i++) {
+        window.insert(data[i]);
+        if (i >= w) window.erase(window.find(data[i - w]));
+        out[i] = *window.begin();
+    }
+}
+
+template <typename F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        vector<int> v = { 4, 2, 12, 3, 8, 1, 7, 9 };
+        MonotonicQueue<int> mins(3);
+        MonotonicQueue<int, greater<int>> maxs(3);
+        cout << "window 3 min/max:";
+        for (int x : v) {
+            mins.push(x);
+            maxs.push(x);
+            cout << " " << mins.front() << "/" << maxs.front();   // 4/4 2/4 2/12 2/12 3/12 1/8 1/8 1/9
+        }
+        cout << "\n";
+
+        TwoStackQueue<GcdMonoid<int>> g;
+        for (int x : { 12, 18, 24, 7 }) g.push(x);
+        cout << "gcd(12, 18, 24, 7) = " << g.query();   // 1
+        g.pop();
+        g.pop();
+        cout << ", after two pops gcd(24, 7) = " << g.query();   // 1
+        g.pop();
+        cout << ", gcd(7) = " << g.query() << "\n";   // 7
+
+        // Composition of x -> 2x + 1 then x -> 3x: 6x + 3
+        TwoStackQueue<AffineMonoid> f;
+        f.push({ 2, 1 });
+        f.push({ 3, 0 });
+        cout << "compose(2x + 1, 3x) = " << f.query().a << "x + " << f.query().b << "\n";
+        try {
+            MonotonicQueue<int> empty(1);
+            empty.popFront();
+        } catch (const out_of_range& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against brute force
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        mt19937_64 rng(7);
+        bool ok = true;
+        for (size_t n : { 1, 2, 5, 100, 5000 }) {
+            vector<int32_t> data(n);
+            for (auto& x : data) x = static_cast<int32_t>(rng() % 50);   // many ties
+            for (size_t w : { 1, 2, 3, 7, 64, 1000 }) {
+                vector<int32_t> expect(n), got(n), batch(n), dq(n), ms(n);
+                for (size_t i = 0; i < n; i++) {
+                    size_t from = i + 1 >= w ? i + 1 - w : 0;
+                    expect[i] = *min_element(data.begin() + from, data.begin() + i + 1);
+                }
+                MonotonicQueue<int32_t> q(w), qb(w);
+                TwoStackQueue<MinMonoid<int32_t>> ts;
+                for (size_t i = 0; i < n; i++) {
+                    q.push(data[i]);
+                    got[i] = q.front();
+                    ts.push(data[i]);
+                    if (ts.size() > w) ts.pop();
+                    ok &= ts.query() == expect[i];
+                }
+                qb.pushBatch(data.data(), n, batch.data());
+                slidingMinDeque(data, w, dq);
+                slidingMinMultiset(data, w, ms);
+                ok &= got == expect && batch == expect && dq == expect && ms == expect;
+                if (n >= w) {
+                    vector<int32_t> vh(n - w + 1);
+                    slidingExtremes(data.data(), n, w, vh.data());
+                    ok &= equal(vh.begin(), vh.end(), expect.begin() + (w - 1));
+                    slidingExtremes(data.data(), n, w, vh.data(), greater<int32_t>());
+                    for (size_t j = 0; j + w <= n; j++)
+                        ok &= vh[j] == *max_element(data.begin() + j, data.begin() + j + w);
+                }
+            }
+        }
+        // Variable window: random pushes and pops, queue against a plain vector.
+        {
+            MonotonicQueue<int32_t, greater<int32_t>> q(100);
+            TwoStackQueue<AffineMonoid> ts;
+            deque<int32_t> ref;
+            deque<AffineMonoid::value_type> refF;
+            for (int step = 0; step < 200000; step++) {
+                if (ref.empty() || rng() % 3) {
+                    int32_t x = static_cast<int32_t>(rng() % 1000);
+                    q.push(x);
+                    ref.push_back(x);
+                    if (ref.size() > 100) ref.pop_front();
+                    AffineMonoid::value_type f = { rng() % AffineMonoid::P, rng() % AffineMonoid::P };
+                    ts.push(f);
+                    refF.push_back(f);
+                } else {
+                    q.popFront();
+                    ref.pop_front();
+                    ts.pop();
+                    refF.pop_front();
+                }
+                if (!ref.empty()) ok &= q.front() == *max_element(ref.begin(), ref.end());
+                if (step % 97 == 0) {
+                    AffineMonoid::value_type acc = AffineMonoid::identity();
+                    for (const auto& f : refF) acc = AffineMonoid::combine(acc, f);
+                    ok &= acc.a == ts.query().a && acc.b == ts.query().b;
+                }
+            }
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoull(argv[1]) : 10'000'000;
+        cout << "Section C: Benchmark, sliding minimum over " << n << " random int32 (ns per element)\n";
+        cout << "  window    deque   multiset  Monotonic  batch   TwoStack  vHGW\n";
+        mt19937_64 rng(8);
+        vector<int32_t> data(n), out(n);
+        for (auto& x : data) x = static_cast<int32_t>(rng());
+        volatile int64_t sink = 0;
+        auto perElem = [&](double ms) { return ms * 1e6 / static_cast<double>(n); };
+
+        for (size_t w : { size_t(16), size_t(1024), size_t(65536) }) {
+            double tDeque = timeMs([&] { slidingMinDeque(data, w, out); });
+            sink = sink + out[n - 1];
+            double tSet = timeMs([&] { slidingMinMultiset(data, w, out); });
+            sink = sink + out[n - 1];
+            double tQueue = timeMs([&] {
+                MonotonicQueue<int32_t> q(w);
+                for (size_t i = 0; i < n; i++) {
+                    q.push(data[i]);
+                    out[i] = q.front();
+                }
+            });
+            sink = sink + out[n - 1];
+            double tBatch = timeMs([&] {
+                MonotonicQueue<int32_t> q(w);
+                q.pushBatch(data.data(), n, out.data());
+            });
+            sink = sink + out[n - 1];
+            double tTwo = timeMs([&] {
+                TwoStackQueue<MinMonoid<int32_t>> q;
+                for (size_t i = 0; i < n; i++) {
+                    q.push(data[i]);
+                    if (q.size() > w) q.pop();
+                    out[i] = q.query();
+                }
+            });
+            sink = sink + out[n - 1];
+            double tVh = timeMs([&] { slidingExtremes(data.data(), n, w, out.data()); });
+            sink = sink + out[0];
+            cout << "  " << w << "\t  " << perElem(tDeque) << "\t  " << perElem(tSet) << "\t  " << perElem(tQueue)
+                 << "\t  " << perElem(tBatch) << "\t  " << perElem(tTwo) << "\t  " << perElem(tVh) << "\n";
+        }
+    }
+
+    return 0;
+}
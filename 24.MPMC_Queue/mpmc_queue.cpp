@@ -0,0 +1,569 @@
+/*
+   ----------------------------------------------------------------------------
+   Bounded Lock-Free MPMC Queue
+   (Vyukov Per-Slot Sequence Numbers, Padded Indices, Batch Push/Pop,
+    Futex-Based Blocking Wrapper)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - The Queue adaptor of stl_intro.txt (std::queue over std::deque) has
+       no thread safety; the usual shared version puts it behind a mutex
+       and two condition variables, so every push and pop from every
+       thread goes through one lock.
+     - MpmcQueue<T> is a ring of 2^k cells; each cell has a sequence number
+       that says whose turn it is:
+           seq == pos          cell is free for the producer of ticket pos
+           seq == pos + 1      cell holds the item for the consumer of pos
+       push: read the enqueue index, check the cell's seq, claim the index
+       with one CAS, write the item, publish seq = pos + 1 (release).
+       pop:  the same on the dequeue index, then seq = pos + capacity, which
+       hands the cell to the producer one lap later. Producers only contend
+       on the enqueue index and consumers on the dequeue index; a full or
+       empty queue is detected from the cell alone, without reading the
+       other side's index.
+     - The two indices sit on separate 64-byte lines (and away from the
+       cell array), so producers and consumers do not invalidate each
+       other's index line on every operation.
+     - try_push_n / try_pop_n claim up to n consecutive ready cells with a
+       SINGLE CAS, so a batch pays for one contended operation instead of n.
+     - BlockingMpmcQueue wraps it with push / pop that sleep when the queue
+       is full / empty. Sleeping uses a Linux futex on an event counter:
+       a waiter reads the counter and arms the event, then re-checks the
+       queue and sleeps only if that still fails and the counter has not
+       moved; the other side bumps the counter and calls futex wake only
+       when the event is armed, once per sleep rather than once per item,
+       so the uncontended path makes no system call. On other platforms
+       the wait falls back to yielding.
+
+   Member Functions (with Complexity):
+
+     MpmcQueue<T>(capacity)         capacity rounded up to a power of two
+     try_push(x) / try_pop(out)     false when full / empty; O(1), lock-free
+     try_push_n(items, n)           number pushed (0 .. n), one CAS
+     try_pop_n(out, n)              number popped (0 .. n), one CAS
+     capacity()
+
+     BlockingMpmcQueue<T>(capacity)
+     push(x) / pop()                wait while full / empty
+     push_n(items, n)               all n, in batches as room appears
+     pop_n(out, n)                  at least 1, at most n
+
+   Measured (Section C, 2^20 items, capacity 1024, ns per item, 1 core):
+       producers = consumers     1      4      16     32
+       mutex + condvar          135    167    701   1314
+       BlockingMpmcQueue         69     61     80     89
+       push_n / pop_n of 32      19     21     36     77
+     The mutex queue degrades as threads pile up on its lock and
+     condition variables; the MPMC queue stays flat because a thread that
+     gets the core completes its operation without waiting for a
+     preempted lock holder.
+
+   Compile:
+       g++ -std=c++17 -O2 -pthread mpmc_queue.cpp -o mpmc_queue
+   Run:
+       ./mpmc_queue [items]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>            // For std::min, std::sort
+#include <atomic>               // For std::atomic
+#include <chrono>               // For benchmarking
+#include <climits>              // For INT_MAX
+#include <condition_variable>   // For the baseline
+#include <cstdint>              // For uint32_t, uint64_t
+#include <mutex>                // For the baseline
+#include <new>                  // For placement new
+#include <queue>                // For the baseline
+#include <string>               // For std::stoull
+#include <thread>               // For std::thread
+
+#if defined(__linux__)
+#include <linux/futex.h>        // For FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h>        // For SYS_futex
+#include <unistd.h>             // For syscall
+#endif
+
+using namespace std;
+
+// ---------------------------------------------------------
+// MpmcQueue
+// ---------------------------------------------------------
+
+template <typename T>
+class MpmcQueue {
+    struct Cell {
+        atomic<size_t> seq;
+        alignas(T) unsigned char raw[sizeof(T)];
+        T* item() { return reinterpret_cast<T*>(raw); }
+    };
+
+public:
+    explicit MpmcQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap *= 2;
+        mask_ = cap - 1;
+        cells_ = new Cell[cap];
+        for (size_t i = 0; i < cap; i++) cells_[i].seq.store(i, memory_order_relaxed);
+    }
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    ~MpmcQueue() {
+        T x;
+        while (try_pop(x)) {}
+        delete[] cells_;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    bool try_push(T x) {
+        size_t pos = enqueue_.load(memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            intptr_t dif = intptr_t(c->seq.load(memory_order_acquire)) - intptr_t(pos);
+            if (dif == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;   // the consumer of the previous lap is not done: full
+            } else {
+                pos = enqueue_.load(memory_order_relaxed);
+            }
+        }
+        new (c->raw) T(std::move(x));
+        c->seq.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        size_t pos = dequeue_.load(memory_order_relaxed);
+        Cell* c;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            intptr_t dif = intptr_t(c->seq.load(memory_order_acquire)) - intptr_t(pos + 1);
+            if (dif == 0) {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;   // not yet written: empty
+            } else {
+                pos = dequeue_.load(memory_order_relaxed);
+            }
+        }
+        out = std::move(*c->item());
+        c->item()->~T();
+        c->seq.store(pos + mask_ + 1, memory_order_release);
+        return true;
+    }
+
+    size_t try_push_n(const T* items, size_t n) {
+        if (n == 0) return 0;
+        size_t pos = enqueue_.load(memory_order_relaxed), k;
+        for (;;) {
+            // Count the free cells from pos on; claim them all at once.
+            for (k = 0; k < n && k <= mask_; k++)
+                if (cells_[(pos + k) & mask_].seq.load(memory_order_acquire) != pos + k) break;
+            if (k == 0) {
+                size_t seq = cells_[pos & mask_].seq.load(memory_order_acquire);
+                if (intptr_t(seq) - intptr_t(pos) < 0) return 0;
+                pos = enqueue_.load(memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_.compare_exchange_weak(pos, pos + k, memory_order_relaxed)) break;
+        }
+        for (size_t j = 0; j < k; j++) {
+            Cell& c = cells_[(pos + j) & mask_];
+            new (c.raw) T(items[j]);
+            c.seq.store(pos + j + 1, memory_order_release);
+        }
+        return k;
+    }
+
+    size_t try_pop_n(T* out, size_t n) {
+        if (n == 0) return 0;
+        size_t pos = dequeue_.load(memory_order_relaxed), k;
+        for (;;) {
+            for (k = 0; k < n && k <= mask_; k++)
+                if (cells_[(pos + k) & mask_].seq.load(memory_order_acquire) != pos + k + 1) break;
+            if (k == 0) {
+                size_t seq = cells_[pos & mask_].seq.load(memory_order_acquire);
+                if (intptr_t(seq) - intptr_t(pos + 1) < 0) return 0;
+                pos = dequeue_.load(memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_.compare_exchange_weak(pos, pos + k, memory_order_relaxed)) break;
+        }
+        for (size_t j = 0; j < k; j++) {
+            Cell& c = cells_[(pos + j) & mask_];
+            out[j] = std::move(*c.item());
+            c.item()->~T();
+            c.seq.store(pos + j + mask_ + 1, memory_order_release);
+        }
+        return k;
+    }
+
+private:
+    alignas(64) atomic<size_t> enqueue_{ 0 };
+    alignas(64) atomic<size_t> dequeue_{ 0 };
+    alignas(64) Cell* cells_;
+    size_t mask_;
+};
+
+// ---------------------------------------------------------
+// Futex event counter and the blocking wrapper
+// ---------------------------------------------------------
+
+// Sleepers wait for `value` to move away from the ticket they read. A
+// sleeper takes a ticket with prepareWait(), which also arms the event,
+// then re-checks its condition and only calls wait() if that still fails.
+// notify() bumps the value and wakes every sleeper only when armed, so
+// later notifies see it disarmed and skip the system call. The seq_cst
+// fences after arming and before reading `armed` make the two sides agree:
+// either the re-check sees the condition or notify sees the event armed.
+class Event {
+public:
+    uint32_t prepareWait() {
+        uint32_t ticket = value_.load(memory_order_acquire);
+        armed_.store(1, memory_order_seq_cst);
+        atomic_thread_fence(memory_order_seq_cst);
+        return ticket;
+    }
+
+    // Returns at once if a notify has bumped the value since prepareWait().
+    void wait(uint32_t ticket) { sleep(ticket); }
+
+    // Call after making the awaited condition true.
+    void notify() {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!armed_.load(memory_order_relaxed) || !armed_.exchange(0, memory_order_seq_cst)) return;
+        value_.fetch_add(1, memory_order_seq_cst);
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+private:
+    void sleep(uint32_t ticket) {
+#if defined(__linux__)
+        static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t), "futex needs a plain 32-bit word");
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value_), FUTEX_WAIT_PRIVATE, ticket, nullptr, nullptr, 0);
+#else
+        (void)ticket;
+        this_thread::yield();
+#endif
+    }
+
+    alignas(64) atomic<uint32_t> value_{ 0 };
+    atomic<uint32_t> armed_{ 0 };
+};
+
+template <typename T>
+class BlockingMpmcQueue {
+public:
+    explicit BlockingMpmcQueue(size_t capacity) : q_(capacity) {}
+
+    void push(const T& x) {
+        for (int spin = 0;; spin++) {
+            if (q_.try_push(x)) break;
+            if (spin < SpinTries) continue;
+            uint32_t t = notFull_.prepareWait();
+            if (q_.try_push(x)) break;
+            notFull_.wait(t);
+        }
+        notEmpty_.notify();
+    }
+
+    T pop() {
+        T x;
+        for (int spin = 0;; spin++) {
+            if (q_.try_pop(x)) break;
+            if (spin < SpinTries) continue;
+            uint32_t t = notEmpty_.prepareWait();
+            if (q_.try_pop(x)) break;
+            notEmpty_.wait(t);
+        }
+        notFull_.notify();
+        return x;
+    }
+
+    void push_n(const T* items, size_t n) {
+        for (size_t done = 0; done < n;) {
+            size_t k = q_.try_push_n(items + done, n - done);
+            if (k) {
+                done += k;
+                notEmpty_.notify();
+                continue;
+            }
+            uint32_t t = notFull_.prepareWait();
+            if ((k = q_.try_push_n(items + done, n - done))) {
+                done += k;
+                notEmpty_.notify();
+                continue;
+            }
+            notFull_.wait(t);
+        }
+    }
+
+    size_t pop_n(T* out, size_t n) {
+        for (;;) {
+            size_t k = q_.try_pop_n(out, n);
+            if (!k) {
+                uint32_t t = notEmpty_.prepareWait();
+                if (!(k = q_.try_pop_n(out, n))) {
+                    notEmpty_.wait(t);
+                    continue;
+                }
+            }
+            notFull_.notify();
+            return k;
+        }
+    }
+
+private:
+    static constexpr int SpinTries = 64;
+    MpmcQueue<T> q_;
+    Event notEmpty_, notFull_;
+};
+
+// Baseline: std::queue behind a mutex and two condition variables.
+template <typename T>
+class LockedQueue {
+public:
+    explicit LockedQueue(size_t capacity) : capacity_(capacity) {}
+
+    void push(const T& x) {
+        unique_lock<mutex> lock(m_);
+        notFull_.wait(lock, [&] { return q_.size() < capacity_; });
+        q_.push(x);
+        lock.unlock();
+        notEmpty_.notify_one();
+    }
+
+    T pop() {
+        unique_lock<mutex> lock(m_);
+        notEmpty_.wait(lock, [&] { return !q_.empty(); });
+        T x = q_.front();
+        q_.pop();
+        lock.unlock();
+        notFull_.notify_one();
+        return x;
+    }
+
+private:
+    mutex m_;
+    condition_variable notEmpty_, notFull_;
+    queue<T> q_;
+    size_t capacity_;
+};
+
+template <typename F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+// `producers` threads push `items` values in total, `consumers` threads pop
+// them; value = producer << 32 | sequence. Returns ms; every consumer's
+// pops are appended to popped[consumer].
+template <typename Push, typename Pop>
+double transfer(int producers, int consumers, uint64_t items, Push push, Pop pop, vector<vector<uint64_t>>& popped) {
+    popped.assign(consumers, {});
+    return timeMs([&] {
+        vector<thread> pool;
+        for (int p = 0; p < producers; p++)
+            pool.emplace_back([&, p] { push(uint64_t(p), items / producers); });
+        for (int c = 0; c < consumers; c++)
+            pool.emplace_back([&, c] { pop(popped[c], items / consumers); });
+        for (auto& th : pool) th.join();
+    });
+}
+
+// Every value exactly once, and each consumer sees each producer's values
+// in increasing order.
+bool checkTransfer(const vector<vector<uint64_t>>& popped, int producers, uint64_t items) {
+    vector<uint64_t> all;
+    for (const auto& part : popped) {
+        vector<uint64_t> last(producers, 0);
+        vector<bool> seen(producers, false);
+        for (uint64_t x : part) {
+            uint64_t p = x >> 32, s = x & 0xffffffff;
+            if (p >= uint64_t(producers) || (seen[p] && s <= last[p])) return false;
+            seen[p] = true;
+            last[p] = s;
+        }
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    if (all.size() != items) return false;
+    sort(all.begin(), all.end());
+    uint64_t each = items / producers;
+    for (uint64_t i = 0; i < items; i++)
+        if (all[i] != ((i / each) << 32 | (i % each))) return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        MpmcQueue<int> q(6);
+        cout << "capacity(6) rounds up to " << q.capacity() << "\n";
+        int pushed = 0;
+        while (q.try_push(pushed)) pushed++;
+        cout << "try_push succeeded " << pushed << " times, then the queue is full\n";
+        int x = -1;
+        q.try_pop(x);
+        cout << "try_pop -> " << x;
+        int out[8];
+        size_t k = q.try_pop_n(out, 8);
+        cout << ", try_pop_n(8) -> " << k << " items:";
+        for (size_t i = 0; i < k; i++) cout << " " << out[i];
+        int batch[] = { 10, 11, 12 };
+        cout << "\ntry_push_n of 3 -> " << q.try_push_n(batch, 3) << "\n";
+
+        BlockingMpmcQueue<int> bq(4);
+        thread producer([&] {
+            for (int i = 1; i <= 10; i++) bq.push(i * i);
+        });
+        cout << "Blocking pops:";
+        for (int i = 0; i < 10; i++) cout << " " << bq.pop();
+        producer.join();
+        cout << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        bool ok = true;
+        const uint64_t items = 1 << 16;
+        vector<vector<uint64_t>> popped;
+
+        // try_ API with a tiny ring, so full / empty are hit constantly.
+        MpmcQueue<uint64_t> raw(8);
+        transfer(4, 4, items,
+                 [&](uint64_t p, uint64_t n) {
+                     for (uint64_t s = 0; s < n; s++)
+                         while (!raw.try_push(p << 32 | s)) this_thread::yield();
+                 },
+                 [&](vector<uint64_t>& got, uint64_t n) {
+                     uint64_t x;
+                     while (got.size() < n)
+                         if (raw.try_pop(x)) got.push_back(x);
+                         else this_thread::yield();
+                 },
+                 popped);
+        ok &= checkTransfer(popped, 4, items);
+
+        // Blocking single and batch calls mixed.
+        BlockingMpmcQueue<uint64_t> bq(16);
+        transfer(8, 2, items,
+                 [&](uint64_t p, uint64_t n) {
+                     uint64_t buf[5];
+                     for (uint64_t s = 0; s < n;) {
+                         if (s % 3 == 0 || n - s < 5) {
+                             bq.push(p << 32 | s++);
+                             continue;
+                         }
+                         for (int j = 0; j < 5; j++) buf[j] = p << 32 | (s + j);
+                         bq.push_n(buf, 5);
+                         s += 5;
+                     }
+                 },
+                 [&](vector<uint64_t>& got, uint64_t n) {
+                     uint64_t buf[7];
+                     while (got.size() < n) {
+                         if (got.size() % 2) {
+                             got.push_back(bq.pop());
+                             continue;
+                         }
+                         size_t k = bq.pop_n(buf, min<uint64_t>(7, n - got.size()));
+                         got.insert(got.end(), buf, buf + k);
+                     }
+                 },
+                 popped);
+        ok &= checkTransfer(popped, 8, items);
+
+        // Blocking stress with a ring of 2: nearly every push and pop goes
+        // through the arm / re-check / sleep path. A lost wake-up hangs here.
+        BlockingMpmcQueue<uint64_t> tiny(2);
+        const uint64_t stress = items * 16;
+        transfer(1, 1, stress,
+                 [&](uint64_t p, uint64_t n) {
+                     for (uint64_t s = 0; s < n; s++) tiny.push(p << 32 | s);
+                 },
+                 [&](vector<uint64_t>& got, uint64_t n) {
+                     while (got.size() < n) got.push_back(tiny.pop());
+                 },
+                 popped);
+        ok &= checkTransfer(popped, 1, stress);
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark
+    // ---------------------------------------------------------
+    {
+        uint64_t items = argc > 1 ? stoull(argv[1]) : (1 << 20);
+        items = items / 32 * 32;   // whole shares for up to 32 threads per side
+        const size_t capacity = 1024, Batch = 32;
+        cout << "Section C: Benchmark, " << items << " items, capacity " << capacity << " (ns/item)\n";
+        cout << "  producers=consumers   mutex+condvar   BlockingMpmc   batch of " << Batch << "\n";
+        vector<vector<uint64_t>> popped;
+        for (int threads = 1; threads <= 32; threads *= 2) {
+            bool ok = true;
+            LockedQueue<uint64_t> lq(capacity);
+            double tLock = transfer(threads, threads, items,
+                                    [&](uint64_t p, uint64_t n) {
+                                        for (uint64_t s = 0; s < n; s++) lq.push(p << 32 | s);
+                                    },
+                                    [&](vector<uint64_t>& got, uint64_t n) {
+                                        got.reserve(n);
+                                        for (uint64_t i = 0; i < n; i++) got.push_back(lq.pop());
+                                    },
+                                    popped);
+            ok &= checkTransfer(popped, threads, items);
+
+            BlockingMpmcQueue<uint64_t> bq(capacity);
+            double tMpmc = transfer(threads, threads, items,
+                                    [&](uint64_t p, uint64_t n) {
+                                        for (uint64_t s = 0; s < n; s++) bq.push(p << 32 | s);
+                                    },
+                                    [&](vector<uint64_t>& got, uint64_t n) {
+                                        got.reserve(n);
+                                        for (uint64_t i = 0; i < n; i++) got.push_back(bq.pop());
+                                    },
+                                    popped);
+            ok &= checkTransfer(popped, threads, items);
+
+            BlockingMpmcQueue<uint64_t> bb(capacity);
+            double tBatch = transfer(threads, threads, items,
+                                     [&](uint64_t p, uint64_t n) {
+                                         uint64_t buf[Batch];
+                                         for (uint64_t s = 0; s < n; s += Batch) {
+                                             size_t m = min<uint64_t>(Batch, n - s);
+                                             for (size_t j = 0; j < m; j++) buf[j] = p << 32 | (s + j);
+                                             bb.push_n(buf, m);
+                                         }
+                                     },
+                                     [&](vector<uint64_t>& got, uint64_t n) {
+                                         got.resize(n);
+                                         for (size_t have = 0; have < n;)
+                                             have += bb.pop_n(&got[have], min<uint64_t>(Batch, n - have));
+                                     },
+                                     popped);
+            ok &= checkTransfer(popped, threads, items);
+            double scale = 1e6 / double(items);
+            cout << "  " << threads << "\t\t\t" << tLock * scale << "\t\t" << tMpmc * scale << "\t\t"
+                 << tBatch * scale << (ok ? "" : "  MISMATCH") << "\n";
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,577 @@
+/*
+   ----------------------------------------------------------------------------
+   Contiguous Stack with Inline Small Storage
+   (First N Elements In-Object, Growable Buffer After, push_n / pop_n,
+    Optional No-Shrink Mode)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - std::stack (Stack in stl_intro.txt) sits on std::deque by default. A
+       deque allocates its map and a 512-byte block as soon as it is
+       constructed, even for a stack that will only ever hold 3 elements,
+       and frees them again on destruction: two heap round trips per
+       short-lived stack, and each push checks for the end of a block.
+     - SmallStack<T, N> keeps the first N elements inside the object (on the
+       caller's stack frame when the SmallStack is a local variable), so a
+       stack that stays within N elements never touches the heap. Beyond N
+       it moves to one contiguous heap buffer that doubles, like a vector:
+       push is then a compare and a store, top() is data[size - 1].
+     - push_n(p, k) copies k elements with one capacity check; pop_n(k)
+       drops k and pop_n(out, k) also copies them out (in their stack order,
+       deepest first). A DFS pushes all neighbours of a vertex in one call.
+     - Shrinking: with ShrinkOnPop = true (default), once a heap buffer is
+       at most a quarter full after a pop it is halved (repeatedly, so
+       pop_n and clear() release a large buffer at once), and the elements
+       go back inline when they fit; the quarter / half gap keeps push/pop
+       around one size from reallocating each time. With ShrinkOnPop =
+       false (NoShrinkStack) the capacity only grows, which suits a stack
+       that is clear()ed and refilled in a loop; shrink_to_fit() releases it
+       explicitly.
+
+   Measured (Section C, 2 * 10^6 stacks / vertices, 1-core VM):
+       short-lived stack of 1-8 ints   std::stack<deque> ~90 ns,
+                                       std::stack<vector> ~145 ns,
+                                       SmallStack<int, 16> ~34 ns
+       DFS, one stack per component    deque ~120 ms, vector ~55 ms,
+                                       SmallStack ~43 ms
+       shunting-yard, 26-char exprs    std::stack ~510 ns, SmallStack ~400 ns
+     push_n did not help the DFS (~53 ms): its neighbours have to be
+     filtered into a scratch buffer first, which costs what the single
+     capacity check saves. It pays off when whole arrays are pushed.
+
+   Member Functions (with Complexity):
+
+     SmallStack<T, N = 16, ShrinkOnPop = true>()    no allocation
+     NoShrinkStack<T, N>                            ShrinkOnPop = false
+     push(x) / emplace(args...)      amortised O(1); x may be an element
+                                     of the stack, e.g. push(top())
+     push_n(p, k)                    amortised O(k)
+     top(), size(), empty()          O(1); top() on empty is undefined
+     pop()                           O(1) (amortised with shrinking)
+     pop_n(k) / pop_n(out, k)        O(k); k > size() throws std::out_of_range
+     capacity(), onHeap()            current capacity / heap buffer in use
+     reserve(n), clear(), shrink_to_fit()
+
+   Compile:
+       g++ -std=c++17 -O2 small_stack.cpp -o small_stack
+   Run:
+       ./small_stack [stacks]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::max
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For int64_t, uint64_t
+#include <memory>      // For std::uninitialized_move, std::uninitialized_copy
+#include <new>         // For placement new
+#include <random>      // For test data
+#include <stack>       // For the baselines
+#include <stdexcept>   // For std::out_of_range
+#include <string>      // For std::string
+#include <utility>     // For std::move, std::forward
+
+using namespace std;
+
+// ---------------------------------------------------------
+// SmallStack
+// ---------------------------------------------------------
+
+template <typename T, size_t N = 16, bool ShrinkOnPop = true>
+class SmallStack {
+    static_assert(N > 0, "inline capacity must be positive");
+
+public:
+    SmallStack() = default;
+
+    SmallStack(const SmallStack& o) {
+        reserve(o.size_);
+        uninitialized_copy(o.data_, o.data_ + o.size_, data_);
+        size_ = o.size_;
+    }
+
+    SmallStack(SmallStack&& o) noexcept { takeFrom(o); }
+
+    SmallStack& operator=(SmallStack o) noexcept {
+        destroyAll();
+        takeFrom(o);
+        return *this;
+    }
+
+    ~SmallStack() { destroyAll(); }
+
+    void push(const T& x) { emplace(x); }
+    void push(T&& x) { emplace(std::move(x)); }
+
+    // The arguments may refer to elements of this stack (s.push(s.top())),
+    // so when the stack is full the new element is built in the new buffer
+    // before the old one is moved out and freed.
+    template <typename... Args>
+    T& emplace(Args&&... args) {
+        T* p;
+        if (size_ == capacity_) {
+            size_t cap = growthFor(size_ + 1);
+            T* fresh = allocate(cap);
+            try {
+                p = new (fresh + size_) T(std::forward<Args>(args)...);
+            } catch (...) {
+                ::operator delete(fresh);
+                throw;
+            }
+            adopt(fresh, cap);
+        } else {
+            p = new (data_ + size_) T(std::forward<Args>(args)...);
+        }
+        size_++;
+        return *p;
+    }
+
+    // items may point into this stack; see emplace.
+    void push_n(const T* items, size_t k) {
+        if (size_ + k > capacity_) {
+            size_t cap = growthFor(size_ + k);
+            T* fresh = allocate(cap);
+            try {
+                uninitialized_copy(items, items + k, fresh + size_);
+            } catch (...) {
+                ::operator delete(fresh);
+                throw;
+            }
+            adopt(fresh, cap);
+        } else {
+            uninitialized_copy(items, items + k, data_ + size_);
+        }
+        size_ += k;
+    }
+
+    T& top() { return data_[size_ - 1]; }
+    const T& top() const { return data_[size_ - 1]; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+    bool onHeap() const { return data_ != inlineData(); }
+
+    void pop() {
+        data_[--size_].~T();
+        maybeShrink();
+    }
+
+    void pop_n(size_t k) {
+        if (k > size_) throw out_of_range("SmallStack: pop_n beyond size");
+        for (size_t i = size_ - k; i < size_; i++) data_[i].~T();
+        size_ -= k;
+        maybeShrink();
+    }
+
+    // Moves the top k elements to out[0 .. k), deepest first.
+    void pop_n(T* out, size_t k) {
+        if (k > size_) throw out_of_range("SmallStack: pop_n beyond size");
+        move(data_ + size_ - k, data_ + size_, out);
+        pop_n(k);
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity_) grow(n);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < size_; i++) data_[i].~T();
+        size_ = 0;
+        maybeShrink();
+    }
+
+    void shrink_to_fit() {
+        if (onHeap()) relocate(max(size_, N));
+    }
+
+private:
+    T* inlineData() { return reinterpret_cast<T*>(inline_); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(inline_); }
+
+    static T* allocate(size_t cap) { return static_cast<T*>(::operator new(cap * sizeof(T))); }
+
+    size_t growthFor(size_t need) const { return max(need, 2 * capacity_); }
+
+    void grow(size_t need) { relocate(growthFor(need)); }
+
+    // Halves the capacity as long as the buffer would stay at most a quarter
+    // full, so pop_n(k) and clear() give back a large buffer in one step.
+    void maybeShrink() {
+        if (!ShrinkOnPop || !onHeap() || size_ > capacity_ / 4) return;
+        size_t cap = max(capacity_ / 2, N);
+        while (cap / 2 >= N && size_ <= cap / 4) cap /= 2;
+        relocate(cap);
+    }
+
+    // Moves the elements into a buffer of `cap` slots (inline if cap == N).
+    void relocate(size_t cap) {
+        T* fresh = cap == N ? inlineData() : allocate(cap);
+        if (fresh == data_) return;
+        adopt(fresh, cap);
+    }
+
+    // Moves the elements into fresh, frees the old buffer and switches to it.
+    void adopt(T* fresh, size_t cap) {
+        uninitialized_move(data_, data_ + size_, fresh);
+        for (size_t i = 0; i < size_; i++) data_[i].~T();
+        if (onHeap()) ::operator delete(data_);
+        data_ = fresh;
+        capacity_ = cap;
+    }
+
+    void destroyAll() {
+        for (size_t i = 0; i < size_; i++) data_[i].~T();
+        if (onHeap()) ::operator delete(data_);
+        data_ = inlineData();
+        size_ = 0;
+        capacity_ = N;
+    }
+
+    // Leaves o empty and inline.
+    void takeFrom(SmallStack& o) {
+        if (o.onHeap()) {
+            data_ = o.data_;
+            capacity_ = o.capacity_;
+            size_ = o.size_;
+            o.data_ = o.inlineData();
+            o.capacity_ = N;
+            o.size_ = 0;
+            return;
+        }
+        uninitialized_move(o.data_, o.data_ + o.size_, data_);
+        size_ = o.size_;
+        o.destroyAll();
+    }
+
+    T* data_ = inlineData();
+    size_t size_ = 0;
+    size_t capacity_ = N;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+};
+
+template <typename T, size_t N = 16>
+using NoShrinkStack = SmallStack<T, N, false>;
+
+// ---------------------------------------------------------
+// Workloads, written once for any stack with push / pop / top / empty
+// ---------------------------------------------------------
+
+// Graph in compressed adjacency form.
+struct Graph {
+    vector<int> start, adj;   // neighbours of v: adj[start[v] .. start[v+1])
+};
+
+// Forest of small random trees (sizes 1 .. 32), edges in both directions.
+Graph smallComponents(int n, mt19937& rng) {
+    vector<vector<int>> lists(n);
+    for (int base = 0; base < n;) {
+        int size = min<int>(1 + static_cast<int>(rng() % 32), n - base);
+        for (int v = 1; v < size; v++) {
+            int parent = base + static_cast<int>(rng() % v);
+            lists[parent].push_back(base + v);
+            lists[base + v].push_back(parent);
+        }
+        base += size;
+    }
+    Graph g;
+    g.start.push_back(0);
+    for (auto& l : lists) {
+        g.adj.insert(g.adj.end(), l.begin(), l.end());
+        g.start.push_back(static_cast<int>(g.adj.size()));
+    }
+    return g;
+}
+
+// Size of the component of every vertex; one DFS (and one fresh stack) per
+// component. UseBulk selects push_n.
+template <typename Stack, bool UseBulk = false>
+uint64_t componentSizes(const Graph& g) {
+    int n = static_cast<int>(g.start.size()) - 1;
+    vector<char> seen(n, 0);
+    uint64_t checksum = 0;
+    for (int s = 0; s < n; s++) {
+        if (seen[s]) continue;
+        Stack st;
+        st.push(s);
+        seen[s] = 1;
+        int count = 0;
+        while (!st.empty()) {
+            int v = st.top();
+            st.pop();
+            count++;
+            int buf[64], m = 0;
+            for (int e = g.start[v]; e < g.start[v + 1]; e++) {
+                int u = g.adj[e];
+                if (seen[u]) continue;
+                seen[u] = 1;
+                if constexpr (UseBulk) {   // collect, then one push_n
+                    buf[m++] = u;
+                    if (m == 64) {
+                        st.push_n(buf, m);
+                        m = 0;
+                    }
+                } else {
+                    st.push(u);
+                }
+            }
+            if constexpr (UseBulk) st.push_n(buf, m);
+        }
+        checksum = checksum * 31 + count;
+    }
+    return checksum;
+}
+
+// Evaluates an expression of non-negative integers, + - * and parentheses
+// with two stacks (shunting-yard). Arithmetic wraps modulo 2^64.
+template <typename ValueStack, typename OpStack>
+int64_t evaluate(const string& e) {
+    ValueStack values;
+    OpStack ops;
+    auto prec = [](char op) { return op == '*' ? 2 : 1; };
+    auto apply = [&] {
+        char op = ops.top();
+        ops.pop();
+        uint64_t b = static_cast<uint64_t>(values.top());
+        values.pop();
+        uint64_t a = static_cast<uint64_t>(values.top());
+        values.pop();
+        values.push(static_cast<int64_t>(op == '+' ? a + b : op == '-' ? a - b : a * b));
+    };
+    for (size_t i = 0; i < e.size(); i++) {
+        char c = e[i];
+        if (c >= '0' && c <= '9') {
+            int64_t v = 0;
+            while (i < e.size() && e[i] >= '0' && e[i] <= '9') v = v * 10 + (e[i++] - '0');
+            i--;
+            values.push(v);
+        } else if (c == '(') {
+            ops.push(c);
+        } else if (c == ')') {
+            while (ops.top() != '(') apply();
+            ops.pop();
+        } else {
+            while (!ops.empty() && ops.top() != '(' && prec(ops.top()) >= prec(c)) apply();
+            ops.push(c);
+        }
+    }
+    while (!ops.empty()) apply();
+    return values.top();
+}
+
+string randomExpression(mt19937& rng, int depth) {
+    if (depth == 0 || rng() % 3 == 0) return to_string(rng() % 100);
+    const char ops[] = { '+', '-', '*' };
+    string left = randomExpression(rng, depth - 1), right = randomExpression(rng, depth - 1);
+    string e = left + ops[rng() % 3] + right;
+    return rng() % 2 ? "(" + e + ")" : e;
+}
+
+template <typename F>
+double timeMs(F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    auto t1 = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        SmallStack<int, 4> s;
+        for (int i = 1; i <= 3; i++) s.push(i * 10);
+        cout << "3 pushes: top " << s.top() << ", size " << s.size() << ", capacity " << s.capacity()
+             << ", on heap " << boolalpha << s.onHeap() << "\n";
+        int more[] = { 40, 50, 60, 70, 80 };
+        s.push_n(more, 5);
+        cout << "push_n of 5: size " << s.size() << ", capacity " << s.capacity() << ", on heap " << s.onHeap()
+             << "\n";
+        int out[3];
+        s.pop_n(out, 3);
+        cout << "pop_n(out, 3): " << out[0] << " " << out[1] << " " << out[2] << ", top now " << s.top() << "\n";
+        s.pop_n(3);
+        cout << "pop_n(3): size " << s.size() << ", capacity " << s.capacity() << ", on heap " << s.onHeap()
+             << " (shrunk back inline)\n";
+
+        NoShrinkStack<string, 2> words;
+        for (const char* w : { "alpha", "beta", "gamma", "delta" }) words.push(w);
+        words.clear();
+        cout << "NoShrinkStack after clear(): capacity " << words.capacity() << ", on heap " << words.onHeap();
+        words.shrink_to_fit();
+        cout << "; after shrink_to_fit(): on heap " << words.onHeap() << noboolalpha << "\n";
+        try {
+            words.pop_n(1);
+        } catch (const out_of_range& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against std::stack
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check\n";
+        bool ok = true;
+        mt19937 rng(11);
+        SmallStack<string, 3> small;
+        NoShrinkStack<string, 3> noShrink;
+        stack<string> ref;
+        for (int step = 0; step < 200000; step++) {
+            unsigned op = rng() % 10;
+            if (op < 5 || ref.empty()) {
+                string x = to_string(rng());
+                small.push(x);
+                noShrink.push(x);
+                ref.push(x);
+            } else if (op < 6) {
+                string batch[4];
+                for (auto& b : batch) {
+                    b = to_string(rng());
+                    ref.push(b);
+                }
+                small.push_n(batch, 4);
+                noShrink.push_n(batch, 4);
+            } else if (op < 9) {
+                small.pop();
+                noShrink.pop();
+                ref.pop();
+            } else {
+                size_t k = min<size_t>(ref.size(), rng() % 6);
+                string a[6], b[6];
+                small.pop_n(a, k);
+                noShrink.pop_n(b, k);
+                for (size_t i = k; i-- > 0;) {
+                    ok &= a[i] == ref.top() && b[i] == ref.top();
+                    ref.pop();
+                }
+            }
+            ok &= small.size() == ref.size() && noShrink.size() == ref.size();
+            if (!ref.empty()) ok &= small.top() == ref.top() && noShrink.top() == ref.top();
+        }
+        SmallStack<string, 3> copy = small, moved = std::move(copy);
+        ok &= copy.empty() && moved.size() == small.size() && (small.empty() || moved.top() == small.top());
+
+        Graph g = smallComponents(1 << 16, rng);
+        uint64_t c1 = componentSizes<stack<int>>(g);
+        ok &= componentSizes<SmallStack<int>>(g) == c1 && componentSizes<SmallStack<int>, true>(g) == c1;
+        for (int i = 0; i < 2000; i++) {
+            string e = randomExpression(rng, 6);
+            ok &= evaluate<SmallStack<int64_t>, SmallStack<char>>(e) == evaluate<stack<int64_t>, stack<char>>(e);
+        }
+        ok &= evaluate<SmallStack<int64_t>, SmallStack<char>>("2*(3+4)-5*6") == -16;
+
+        // Arguments that alias the stack's own elements, across every growth
+        // (inline to heap and heap to heap).
+        SmallStack<string, 2> self;
+        SmallStack<int, 2> selfInts;
+        stack<string> selfRef;
+        for (int i = 0; i < 300; i++) {
+            if (i % 5 == 0 || self.size() < 2) {
+                string x = string(30, 'a') + to_string(i);   // beyond the SSO buffer
+                self.push(x);
+                selfInts.push(i);
+                selfRef.push(x);
+            } else if (i % 5 == 1) {
+                self.push_n(&self.top() - 1, 2);   // the top two, again
+                selfInts.push_n(&selfInts.top() - 1, 2);
+                string top = selfRef.top();
+                selfRef.pop();
+                string below = selfRef.top();
+                selfRef.push(top);
+                selfRef.push(below);
+                selfRef.push(top);
+            } else {
+                self.push(self.top());
+                selfInts.push(selfInts.top());
+                selfRef.push(selfRef.top());
+            }
+        }
+        ok &= self.size() == selfRef.size() && selfInts.size() == selfRef.size();
+        while (!selfRef.empty()) {
+            ok &= self.top() == selfRef.top() && selfInts.top() == stoi(selfRef.top().substr(30));
+            self.pop();
+            selfInts.pop();
+            selfRef.pop();
+        }
+
+        // clear() gives a large buffer back in one step unless NoShrink.
+        NoShrinkStack<int, 2> keep;
+        SmallStack<int, 2> shrink;
+        for (int i = 0; i < 1000; i++) keep.push(i), shrink.push(i);
+        keep.clear();
+        shrink.clear();
+        ok &= keep.capacity() >= 1000 && shrink.capacity() == 2 && !shrink.onHeap();
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark
+    // ---------------------------------------------------------
+    {
+        size_t stacks = argc > 1 ? stoull(argv[1]) : 2'000'000;
+        cout << "Section C: Benchmark\n";
+        volatile long long sink = 0;
+        mt19937 rng(12);
+
+        // Short-lived stacks of 1 .. 8 ints.
+        vector<int> depth(stacks);
+        for (auto& d : depth) d = 1 + static_cast<int>(rng() % 8);
+        auto shortLived = [&](auto tag) {
+            using Stack = typename decltype(tag)::type;
+            return timeMs([&] {
+                long long s = 0;
+                for (size_t i = 0; i < stacks; i++) {
+                    Stack st;
+                    for (int j = 0; j < depth[i]; j++) st.push(j);
+                    while (!st.empty()) {
+                        s += st.top();
+                        st.pop();
+                    }
+                }
+                sink = s;
+            }) * 1e6 / stacks;
+        };
+        struct DequeTag { using type = stack<int>; };
+        struct VectorTag { using type = stack<int, vector<int>>; };
+        struct SmallTag { using type = SmallStack<int>; };
+        cout << "  short-lived stack, 1-8 ints (ns/stack): std::stack<deque> " << shortLived(DequeTag{})
+             << ", std::stack<vector> " << shortLived(VectorTag{}) << ", SmallStack<int, 16> "
+             << shortLived(SmallTag{}) << "\n";
+
+        // DFS, one stack per component of a forest of small trees.
+        Graph g = smallComponents(static_cast<int>(stacks), rng);
+        uint64_t r1 = 0, r2 = 0, r3 = 0, r4 = 0;
+        double d1 = timeMs([&] { r1 = componentSizes<stack<int>>(g); });
+        double d2 = timeMs([&] { r2 = componentSizes<stack<int, vector<int>>>(g); });
+        double d3 = timeMs([&] { r3 = componentSizes<SmallStack<int>>(g); });
+        double d4 = timeMs([&] { r4 = componentSizes<SmallStack<int>, true>(g); });
+        cout << "  DFS over " << stacks << " vertices (ms): std::stack<deque> " << d1 << ", std::stack<vector> "
+             << d2 << ", SmallStack " << d3 << ", SmallStack + push_n " << d4
+             << (r1 == r2 && r1 == r3 && r1 == r4 ? "" : "  MISMATCH") << "\n";
+
+        // Expression evaluation, two fresh stacks per expression.
+        vector<string> exprs(stacks / 20);
+        size_t chars = 0;
+        for (auto& e : exprs) {
+            e = randomExpression(rng, 5);
+            chars += e.size();
+        }
+        uint64_t e1 = 0, e2 = 0;   // sums wrap
+        double x1 = timeMs([&] {
+            for (auto& e : exprs) e1 += static_cast<uint64_t>(evaluate<stack<int64_t>, stack<char>>(e));
+        });
+        double x2 = timeMs([&] {
+            for (auto& e : exprs) e2 += static_cast<uint64_t>(evaluate<SmallStack<int64_t>, SmallStack<char>>(e));
+        });
+        cout << "  " << exprs.size() << " expressions, avg " << chars / max<size_t>(exprs.size(), 1)
+             << " chars (ns/expr): std::stack " << x1 * 1e6 / exprs.size() << ", SmallStack " << x2 * 1e6 / exprs.size()
+             << (e1 == e2 ? "" : "  MISMATCH") << "\n";
+    }
+
+    return 0;
+}
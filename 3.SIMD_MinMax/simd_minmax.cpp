@@ -0,0 +1,507 @@
+/*
+   ----------------------------------------------------------------------------
+   SIMD Extrema and Counting: argmin / argmax / minmax / count_if Kernels
+   for std::array and std::vector (AVX2 with Runtime Dispatch)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - std::min_element, std::max_element and std::count (see the
+       Non-Manipulative Algorithms part of stl_intro.txt) are written as
+       plain loops with a data-dependent branch per element.
+     - The kernels below scan a contiguous range (anything with data() and
+       size(): std::array, std::vector, a raw pointer + length) and return the
+       extreme VALUE and its INDEX together, so the caller never has to
+       dereference an iterator afterwards.
+     - Each kernel has a portable scalar version and an AVX2 version for
+       int32_t and float. The AVX2 version is compiled with a function-level
+       target attribute, so the program itself does not need -mavx2; the CPU
+       is queried once at start-up and the fastest supported version is used.
+
+   Kernels (with Complexity and Use Cases):
+
+     1. argMin(ptr, n) / argMax(ptr, n)
+          - Return { value, index } of the FIRST minimum / maximum, i.e. the
+            same element std::min_element / std::max_element would find.
+          - Complexity: O(n); 8 elements per step with AVX2.
+          - Usage: auto r = argMin(v.data(), v.size()); r.value, r.index
+
+     2. minMax(ptr, n)
+          - Fused single pass returning both the minimum and the maximum with
+            their indices.
+          - Note: the index of the maximum is its FIRST occurrence, whereas
+            std::minmax_element reports the LAST maximum.
+          - Complexity: O(n); one pass instead of two.
+          - Usage: auto r = minMax(v.data(), v.size()); r.min, r.max
+
+     3. countIf(ptr, n, op, value)
+          - Counts elements x with (x op value), where op is one of
+            EQ, NE, LT, LE, GT, GE.
+          - countIf(ptr, n, CmpOp::EQ, value) is std::count.
+          - Complexity: O(n), branch-free.
+          - Usage: countIf(v.data(), v.size(), CmpOp::GT, 100)
+
+   Notes:
+     - Calling argMin / argMax / minMax on an empty range is a precondition
+       violation (there is no element to return); the kernels throw
+       std::invalid_argument, mirroring at() rather than operator[].
+     - For float, the result is unspecified if the range contains NaN.
+     - Indices are tracked in 32-bit SIMD lanes, so ranges longer than
+       INT32_MAX elements fall back to the scalar loop.
+     - Runtime dispatch relies on __builtin_cpu_supports and
+       __attribute__((target)), available in GCC and Clang on x86-64. On other
+       compilers / architectures only the scalar path is built.
+
+   Compile:
+       g++ -std=c++17 -O2 simd_minmax.cpp -o simd_minmax
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <array>
+#include <vector>
+#include <algorithm>  // For std::min_element, std::max_element, std::count_if
+#include <chrono>     // For benchmarking
+#include <cstdint>    // For int32_t
+#include <limits>     // For std::numeric_limits
+#include <random>     // For test data
+#include <stdexcept>  // For std::invalid_argument
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_MINMAX_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// ---------------------------------------------------------
+// Result types and comparison operators
+// ---------------------------------------------------------
+
+template <typename T>
+struct ValIdx {
+    T value;
+    size_t index;
+};
+
+template <typename T>
+struct MinMaxResult {
+    ValIdx<T> min;
+    ValIdx<T> max;
+};
+
+enum class CmpOp { EQ, NE, LT, LE, GT, GE };
+
+template <typename T>
+inline bool applyCmp(CmpOp op, T x, T value) {
+    switch (op) {
+        case CmpOp::EQ: return x == value;
+        case CmpOp::NE: return x != value;
+        case CmpOp::LT: return x < value;
+        case CmpOp::LE: return x <= value;
+        case CmpOp::GT: return x > value;
+        case CmpOp::GE: return x >= value;
+    }
+    return false;
+}
+
+inline void requireNonEmpty(size_t n) {
+    if (n == 0)
+        throw invalid_argument("extrema of an empty range");
+}
+
+// ---------------------------------------------------------
+// Scalar kernels (any ordered T)
+// ---------------------------------------------------------
+
+template <typename T>
+ValIdx<T> argMinScalar(const T* p, size_t n) {
+    requireNonEmpty(n);
+    ValIdx<T> best { p[0], 0 };
+    for (size_t i = 1; i < n; i++) {
+        if (p[i] < best.value) {
+            best.value = p[i];
+            best.index = i;
+        }
+    }
+    return best;
+}
+
+template <typename T>
+ValIdx<T> argMaxScalar(const T* p, size_t n) {
+    requireNonEmpty(n);
+    ValIdx<T> best { p[0], 0 };
+    for (size_t i = 1; i < n; i++) {
+        if (best.value < p[i]) {
+            best.value = p[i];
+            best.index = i;
+        }
+    }
+    return best;
+}
+
+template <typename T>
+MinMaxResult<T> minMaxScalar(const T* p, size_t n) {
+    requireNonEmpty(n);
+    MinMaxResult<T> r { { p[0], 0 }, { p[0], 0 } };
+    for (size_t i = 1; i < n; i++) {
+        if (p[i] < r.min.value) { r.min.value = p[i]; r.min.index = i; }
+        if (r.max.value < p[i]) { r.max.value = p[i]; r.max.index = i; }
+    }
+    return r;
+}
+
+template <typename T>
+size_t countIfScalar(const T* p, size_t n, CmpOp op, T value) {
+    size_t cnt = 0;
+    for (size_t i = 0; i < n; i++)
+        cnt += applyCmp(op, p[i], value) ? 1 : 0;
+    return cnt;
+}
+
+// ---------------------------------------------------------
+// AVX2 kernels (int32_t and float)
+// ---------------------------------------------------------
+// Each lane keeps its own running extreme and the index where it was seen.
+// A strict comparison keeps the earliest index inside a lane; the final
+// horizontal step picks the extreme value and, among lanes holding it, the
+// smallest index, so the overall result is the first occurrence.
+
+#ifdef SIMD_MINMAX_X86
+
+namespace avx2 {
+
+// Lane-wise "a better than b" for the two element types.
+__attribute__((target("avx2"))) inline __m256i lessThan(__m256i a, __m256i b) {
+    return _mm256_cmpgt_epi32(b, a);
+}
+__attribute__((target("avx2"))) inline __m256i lessThan(__m256 a, __m256 b) {
+    return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+}
+__attribute__((target("avx2"))) inline __m256i blendV(__m256i a, __m256i b, __m256i m) {
+    return _mm256_blendv_epi8(a, b, m);
+}
+__attribute__((target("avx2"))) inline __m256 blendV(__m256 a, __m256 b, __m256i m) {
+    return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(m));
+}
+__attribute__((target("avx2"))) inline __m256i loadV(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+__attribute__((target("avx2"))) inline __m256 loadV(const float* p) {
+    return _mm256_loadu_ps(p);
+}
+__attribute__((target("avx2"))) inline __m256i splatV(int32_t x) { return _mm256_set1_epi32(x); }
+__attribute__((target("avx2"))) inline __m256 splatV(float x) { return _mm256_set1_ps(x); }
+__attribute__((target("avx2"))) inline void storeV(int32_t* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+__attribute__((target("avx2"))) inline void storeV(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+
+template <typename T> struct Vec;
+template <> struct Vec<int32_t> { using type = __m256i; };
+template <> struct Vec<float> { using type = __m256; };
+
+// Reduce 8 (value, index) lanes plus a scalar tail to the first extreme.
+// IsMax flips the comparison without duplicating the loop.
+template <bool IsMax, typename T>
+ValIdx<T> reduceLanes(const T* vals, const int32_t* idx, const T* p, size_t from, size_t n) {
+    ValIdx<T> best { vals[0], static_cast<size_t>(idx[0]) };
+    for (int l = 1; l < 8; l++) {
+        bool better = IsMax ? (best.value < vals[l]) : (vals[l] < best.value);
+        bool tie = !(vals[l] < best.value) && !(best.value < vals[l]);
+        if (better || (tie && static_cast<size_t>(idx[l]) < best.index)) {
+            best.value = vals[l];
+            best.index = static_cast<size_t>(idx[l]);
+        }
+    }
+    for (size_t i = from; i < n; i++) {
+        bool better = IsMax ? (best.value < p[i]) : (p[i] < best.value);
+        if (better) { best.value = p[i]; best.index = i; }
+    }
+    return best;
+}
+
+template <bool IsMax, typename T>
+__attribute__((target("avx2"))) ValIdx<T> argExtreme(const T* p, size_t n) {
+    using V = typename Vec<T>::type;
+    requireNonEmpty(n);
+    if (n < 8 || n > static_cast<size_t>(numeric_limits<int32_t>::max()))
+        return IsMax ? argMaxScalar(p, n) : argMinScalar(p, n);
+
+    V best = loadV(p);
+    __m256i bestIdx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i curIdx = bestIdx;
+    const __m256i step = _mm256_set1_epi32(8);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        curIdx = _mm256_add_epi32(curIdx, step);
+        V x = loadV(p + i);
+        __m256i m = IsMax ? lessThan(best, x) : lessThan(x, best);
+        best = blendV(best, x, m);
+        bestIdx = blendV(bestIdx, curIdx, m);
+    }
+    alignas(32) T vals[8];
+    alignas(32) int32_t idx[8];
+    storeV(vals, best);
+    storeV(idx, bestIdx);
+    return reduceLanes<IsMax>(vals, idx, p, i, n);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) MinMaxResult<T> minMax(const T* p, size_t n) {
+    using V = typename Vec<T>::type;
+    requireNonEmpty(n);
+    if (n < 8 || n > static_cast<size_t>(numeric_limits<int32_t>::max()))
+        return minMaxScalar(p, n);
+
+    V lo = loadV(p), hi = lo;
+    __m256i loIdx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i hiIdx = loIdx, curIdx = loIdx;
+    const __m256i step = _mm256_set1_epi32(8);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        curIdx = _mm256_add_epi32(curIdx, step);
+        V x = loadV(p + i);
+        __m256i mLo = lessThan(x, lo);
+        __m256i mHi = lessThan(hi, x);
+        lo = blendV(lo, x, mLo);
+        loIdx = blendV(loIdx, curIdx, mLo);
+        hi = blendV(hi, x, mHi);
+        hiIdx = blendV(hiIdx, curIdx, mHi);
+    }
+    alignas(32) T vals[8];
+    alignas(32) int32_t idx[8];
+    MinMaxResult<T> r;
+    storeV(vals, lo);
+    storeV(idx, loIdx);
+    r.min = reduceLanes<false>(vals, idx, p, i, n);
+    storeV(vals, hi);
+    storeV(idx, hiIdx);
+    r.max = reduceLanes<true>(vals, idx, p, i, n);
+    return r;
+}
+
+__attribute__((target("avx2"))) inline __m256i cmpMask(CmpOp op, __m256i x, __m256i v) {
+    switch (op) {
+        case CmpOp::EQ: return _mm256_cmpeq_epi32(x, v);
+        case CmpOp::NE: return _mm256_xor_si256(_mm256_cmpeq_epi32(x, v), _mm256_set1_epi32(-1));
+        case CmpOp::LT: return _mm256_cmpgt_epi32(v, x);
+        case CmpOp::LE: return _mm256_xor_si256(_mm256_cmpgt_epi32(x, v), _mm256_set1_epi32(-1));
+        case CmpOp::GT: return _mm256_cmpgt_epi32(x, v);
+        case CmpOp::GE: return _mm256_xor_si256(_mm256_cmpgt_epi32(v, x), _mm256_set1_epi32(-1));
+    }
+    return _mm256_setzero_si256();
+}
+__attribute__((target("avx2"))) inline __m256i cmpMask(CmpOp op, __m256 x, __m256 v) {
+    __m256 m;
+    switch (op) {
+        case CmpOp::EQ: m = _mm256_cmp_ps(x, v, _CMP_EQ_OQ); break;
+        case CmpOp::NE: m = _mm256_cmp_ps(x, v, _CMP_NEQ_UQ); break;
+        case CmpOp::LT: m = _mm256_cmp_ps(x, v, _CMP_LT_OQ); break;
+        case CmpOp::LE: m = _mm256_cmp_ps(x, v, _CMP_LE_OQ); break;
+        case CmpOp::GT: m = _mm256_cmp_ps(x, v, _CMP_GT_OQ); break;
+        default:        m = _mm256_cmp_ps(x, v, _CMP_GE_OQ); break;
+    }
+    return _mm256_castps_si256(m);
+}
+
+// Matching lanes are -1, so subtracting the mask adds one per match.
+// Lane counters are flushed before they can overflow.
+template <typename T>
+__attribute__((target("avx2"))) size_t countIf(const T* p, size_t n, CmpOp op, T value) {
+    using V = typename Vec<T>::type;
+    const V v = splatV(value);
+    const size_t flushEvery = size_t(1) << 28;
+    size_t total = 0, i = 0;
+    while (i + 8 <= n) {
+        __m256i acc = _mm256_setzero_si256();
+        size_t stop = min(n - (n - i) % 8, i + flushEvery * 8);
+        for (; i < stop; i += 8)
+            acc = _mm256_sub_epi32(acc, cmpMask(op, loadV(p + i), v));
+        alignas(32) int32_t lanes[8];
+        storeV(lanes, acc);
+        for (int l = 0; l < 8; l++) total += static_cast<uint32_t>(lanes[l]);
+    }
+    return total + countIfScalar(p + i, n - i, op, value);
+}
+
+} // namespace avx2
+
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+}
+
+#endif // SIMD_MINMAX_X86
+
+// ---------------------------------------------------------
+// Public entry points (dispatch once per call on a cached CPU flag)
+// ---------------------------------------------------------
+
+template <typename T>
+ValIdx<T> argMin(const T* p, size_t n) {
+#ifdef SIMD_MINMAX_X86
+    if constexpr (is_same_v<T, int32_t> || is_same_v<T, float>)
+        if (hasAvx2()) return avx2::argExtreme<false>(p, n);
+#endif
+    return argMinScalar(p, n);
+}
+
+template <typename T>
+ValIdx<T> argMax(const T* p, size_t n) {
+#ifdef SIMD_MINMAX_X86
+    if constexpr (is_same_v<T, int32_t> || is_same_v<T, float>)
+        if (hasAvx2()) return avx2::argExtreme<true>(p, n);
+#endif
+    return argMaxScalar(p, n);
+}
+
+template <typename T>
+MinMaxResult<T> minMax(const T* p, size_t n) {
+#ifdef SIMD_MINMAX_X86
+    if constexpr (is_same_v<T, int32_t> || is_same_v<T, float>)
+        if (hasAvx2()) return avx2::minMax(p, n);
+#endif
+    return minMaxScalar(p, n);
+}
+
+template <typename T>
+size_t countIf(const T* p, size_t n, CmpOp op, T value) {
+#ifdef SIMD_MINMAX_X86
+    if constexpr (is_same_v<T, int32_t> || is_same_v<T, float>)
+        if (hasAvx2()) return avx2::countIf(p, n, op, value);
+#endif
+    return countIfScalar(p, n, op, value);
+}
+
+// Convenience overloads for any contiguous container (std::array, std::vector).
+template <typename C> auto argMin(const C& c) { return argMin(c.data(), c.size()); }
+template <typename C> auto argMax(const C& c) { return argMax(c.data(), c.size()); }
+template <typename C> auto minMax(const C& c) { return minMax(c.data(), c.size()); }
+template <typename C, typename T>
+size_t countIf(const C& c, CmpOp op, T value) {
+    return countIf(c.data(), c.size(), op, static_cast<typename C::value_type>(value));
+}
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double bestMillis(int reps, F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < reps; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+static volatile size_t sink;
+
+template <typename C>
+void benchContainer(const char* label, const C& c, int reps) {
+    using T = typename C::value_type;
+    const T* p = c.data();
+    size_t n = c.size();
+    cout << label << " (n = " << n << ")\n";
+
+    double tStd = bestMillis(reps, [&] { sink = min_element(c.begin(), c.end()) - c.begin(); });
+    double tOur = bestMillis(reps, [&] { sink = argMin(p, n).index; });
+    cout << "  min_element        : " << tStd << " ms   argMin  : " << tOur << " ms\n";
+
+    tStd = bestMillis(reps, [&] { sink = max_element(c.begin(), c.end()) - c.begin(); });
+    tOur = bestMillis(reps, [&] { sink = argMax(p, n).index; });
+    cout << "  max_element        : " << tStd << " ms   argMax  : " << tOur << " ms\n";
+
+    tStd = bestMillis(reps, [&] {
+        auto mm = minmax_element(c.begin(), c.end());
+        sink = (mm.first - c.begin()) + (mm.second - c.begin());
+    });
+    tOur = bestMillis(reps, [&] { auto r = minMax(p, n); sink = r.min.index + r.max.index; });
+    cout << "  minmax_element     : " << tStd << " ms   minMax  : " << tOur << " ms\n";
+
+    T pivot = c[n / 2];
+    tStd = bestMillis(reps, [&] { sink = count_if(c.begin(), c.end(), [&](T x) { return x > pivot; }); });
+    tOur = bestMillis(reps, [&] { sink = countIf(p, n, CmpOp::GT, pivot); });
+    cout << "  count_if(x > pivot): " << tStd << " ms   countIf : " << tOur << " ms\n";
+}
+
+int main() {
+    // ---------------------------------------------------------
+    // Section A: Basic usage on std::array and std::vector
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+#ifdef SIMD_MINMAX_X86
+        cout << "AVX2 available: " << (hasAvx2() ? "Yes" : "No") << "\n";
+#endif
+        array<int32_t, 12> arr { 7, 3, 9, 3, 12, -4, 8, 12, -4, 0, 5, 6 };
+        auto mn = argMin(arr);
+        auto mx = argMax(arr);
+        cout << "argMin: value " << mn.value << " at index " << mn.index << "\n";   // -4 at 5
+        cout << "argMax: value " << mx.value << " at index " << mx.index << "\n";   // 12 at 4
+        cout << "count(x == 3): " << countIf(arr, CmpOp::EQ, 3) << "\n";            // 2
+        cout << "count(x >= 8): " << countIf(arr, CmpOp::GE, 8) << "\n";            // 4
+
+        vector<float> vf { 2.5f, -1.0f, 7.25f, 3.0f, -1.0f, 7.25f, 0.5f, 1.5f, 9.0f, -3.5f };
+        auto mm = minMax(vf);
+        cout << "minMax (float): min " << mm.min.value << " @" << mm.min.index
+             << ", max " << mm.max.value << " @" << mm.max.index << "\n";
+
+        try {
+            vector<int32_t> empty;
+            argMin(empty);
+        } catch (const invalid_argument& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against the standard algorithms
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check against <algorithm>\n";
+        mt19937 rng(12345);
+        bool ok = true;
+        for (size_t n = 1; n < 200; n++) {
+            vector<int32_t> v(n);
+            for (auto& x : v) x = static_cast<int32_t>(rng() % 50) - 25;   // many ties
+            size_t iMin = min_element(v.begin(), v.end()) - v.begin();
+            size_t iMax = max_element(v.begin(), v.end()) - v.begin();
+            auto mm = minMax(v);
+            ok &= argMin(v).index == iMin && argMax(v).index == iMax;
+            ok &= mm.min.index == iMin && mm.max.index == iMax;
+            for (CmpOp op : { CmpOp::EQ, CmpOp::NE, CmpOp::LT, CmpOp::LE, CmpOp::GT, CmpOp::GE })
+                ok &= countIf(v, op, 3) == countIfScalar(v.data(), n, op, 3);
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmarks (best of several runs)
+    // ---------------------------------------------------------
+    {
+        cout << "Section C: Benchmarks\n";
+        mt19937 rng(2024);
+
+        // std::array is fixed-size; keep it static so it does not live on the stack.
+        static array<int32_t, (1 << 16)> arr;
+        for (auto& x : arr) x = static_cast<int32_t>(rng());
+        benchContainer("std::array<int32_t>", arr, 200);
+
+        vector<int32_t> vi(1 << 24);
+        for (auto& x : vi) x = static_cast<int32_t>(rng());
+        benchContainer("std::vector<int32_t>", vi, 5);
+
+        vector<float> vf(1 << 24);
+        uniform_real_distribution<float> dist(-1e6f, 1e6f);
+        for (auto& x : vf) x = dist(rng);
+        benchContainer("std::vector<float>", vf, 5);
+    }
+
+    return 0;
+}
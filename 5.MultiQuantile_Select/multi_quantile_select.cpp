@@ -0,0 +1,524 @@
+/*
+   ----------------------------------------------------------------------------
+   Multi-Quantile Selection: Introselect for Several Order Statistics at Once
+   (SIMD Partitioning, Parallel Variant, partial_sort Built on Top)
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - std::nth_element (a Manipulative Algorithm, see stl_intro.txt) finds ONE
+       order statistic in O(n). Computing p50, p99 and p999 of the same vector
+       with three nth_element calls partitions the data three times.
+     - multiSelect() takes a list of ranks and partitions recursively ONCE:
+       after choosing a pivot and partitioning, the rank list is split and
+       only the sides that still contain a requested rank are visited. With
+       k ranks the total work is about O(n log k) instead of O(k n).
+     - It is an introselect: if the recursion gets deeper than 2 log2(n)
+       (bad pivots), the remaining subrange falls back to std::nth_element,
+       so the worst case stays O(n log n).
+
+   Partitioning:
+     - Each step is a three-way split (< pivot, == pivot, > pivot) done as two
+       two-way passes; the "== pivot" block is final, so heavy duplicates
+       (common in latency data) still make progress.
+     - The two-way pass is branchless: elements that go left are compacted in
+       place, elements that go right are appended to a scratch buffer and
+       copied back afterwards.
+     - For int32_t and float an AVX2 pass handles 8 elements per step using a
+       movemask -> permutation lookup table (AVX2 has no compress
+       instruction). The CPU is checked once at run time.
+
+   Functions (with Complexity and Use Cases):
+
+     1. multiSelect(v, ranks)
+          - Afterwards v[r] holds the value a full sort would put at r, for
+            every r in ranks, and every element before v[r] is <= v[r] and
+            every element after is >= v[r] (nth_element guarantees, for all
+            ranks at once).
+          - Complexity: O(n log k) expected, O(n log n) worst case.
+
+     2. multiSelectParallel(v, ranks, threads = hardware_concurrency)
+          - Same result; large partitions are split across threads (each thread
+            partitions its chunk, then the chunks are scattered into place)
+            and independent sides of the recursion run concurrently.
+
+     3. quantiles(v, qs, parallel = false)
+          - Returns the nearest-rank quantile for every q in qs, i.e. the value
+            at rank ceil(q * n) - 1 (clamped to [0, n - 1]).
+          - Usage: auto p = quantiles(latencies, { 0.5, 0.99, 0.999 });
+
+     4. partialSortFast(v, k)
+          - Same result as std::partial_sort(v.begin(), v.begin() + k, v.end()):
+            select rank k - 1, then sort only the first k elements.
+          - Complexity: O(n + k log k) expected instead of O(n log k).
+
+   Notes:
+     - Ranks >= v.size() or quantiles outside [0, 1] throw std::out_of_range /
+       std::invalid_argument.
+     - The functions reorder v, like std::nth_element does; pass a copy if the
+       original order is needed.
+     - For float, behavior is unspecified if v contains NaN.
+
+   Compile:
+       g++ -std=c++17 -O2 -pthread multi_quantile_select.cpp -o multi_quantile_select
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>   // For std::nth_element, std::sort, std::partial_sort
+#include <chrono>      // For benchmarking
+#include <cmath>       // For std::ceil, std::log2
+#include <cstdint>     // For int32_t
+#include <cstring>     // For std::memcpy
+#include <future>      // For std::async
+#include <limits>      // For std::numeric_limits
+#include <random>      // For test data
+#include <stdexcept>   // For std::out_of_range, std::invalid_argument
+#include <thread>      // For std::thread
+#include <type_traits> // For std::is_same_v, std::is_trivially_copyable_v
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MULTI_SELECT_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Below this size a subrange is simply sorted.
+constexpr size_t SmallSortCutoff = 32;
+// Partitions at least this large are split across threads in the parallel variant.
+constexpr size_t ParallelCutoff = size_t(1) << 20;
+
+// ---------------------------------------------------------
+// Two-way partition: scalar version (any trivially copyable T)
+// ---------------------------------------------------------
+// Moves every x with (x < pivot), or (x <= pivot) when OrEqual, to the front
+// and returns how many there are. scratch must hold n + 8 elements.
+
+template <bool OrEqual, typename T>
+size_t partitionScalar(T* a, size_t n, const T& pivot, T* scratch) {
+    size_t l = 0, r = 0;
+    for (size_t i = 0; i < n; i++) {
+        T x = a[i];
+        bool left = OrEqual ? !(pivot < x) : (x < pivot);
+        a[l] = x;           // l <= i, so this never overwrites unread input
+        scratch[r] = x;
+        l += left;
+        r += !left;
+    }
+    memcpy(static_cast<void*>(a + l), scratch, r * sizeof(T));
+    return l;
+}
+
+// ---------------------------------------------------------
+// Two-way partition: AVX2 version (int32_t and float)
+// ---------------------------------------------------------
+
+#ifdef MULTI_SELECT_X86
+
+namespace avx2 {
+
+// compactLut[bits] lists the lanes whose bit is set, followed by the others.
+struct CompactLut {
+    alignas(32) array<array<uint32_t, 8>, 256> idx;
+    CompactLut() {
+        for (unsigned bits = 0; bits < 256; bits++) {
+            unsigned k = 0;
+            for (unsigned lane = 0; lane < 8; lane++)
+                if (bits & (1u << lane)) idx[bits][k++] = lane;
+            for (unsigned lane = 0; lane < 8; lane++)
+                if (!(bits & (1u << lane))) idx[bits][k++] = lane;
+        }
+    }
+};
+static const CompactLut compactLut;
+
+__attribute__((target("avx2"))) inline __m256i lutAt(unsigned bits) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(compactLut.idx[bits].data()));
+}
+
+// Bitmask of lanes that go left, for each element type.
+template <bool OrEqual>
+__attribute__((target("avx2"))) inline unsigned leftBits(__m256i x, __m256i p) {
+    unsigned gt = _mm256_movemask_ps(_mm256_castsi256_ps(
+        OrEqual ? _mm256_cmpgt_epi32(x, p) : _mm256_cmpgt_epi32(p, x)));
+    return OrEqual ? (~gt & 0xFFu) : gt;
+}
+template <bool OrEqual>
+__attribute__((target("avx2"))) inline unsigned leftBits(__m256 x, __m256 p) {
+    return _mm256_movemask_ps(OrEqual ? _mm256_cmp_ps(x, p, _CMP_LE_OQ) : _mm256_cmp_ps(x, p, _CMP_LT_OQ));
+}
+
+__attribute__((target("avx2"))) inline __m256i loadV(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+__attribute__((target("avx2"))) inline __m256 loadV(const float* p) { return _mm256_loadu_ps(p); }
+__attribute__((target("avx2"))) inline __m256i splatV(int32_t x) { return _mm256_set1_epi32(x); }
+__attribute__((target("avx2"))) inline __m256 splatV(float x) { return _mm256_set1_ps(x); }
+__attribute__((target("avx2"))) inline void storeV(int32_t* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+__attribute__((target("avx2"))) inline void storeV(float* p, __m256 v) { _mm256_storeu_ps(p, v); }
+__attribute__((target("avx2"))) inline __m256i permuteV(__m256i x, __m256i idx) {
+    return _mm256_permutevar8x32_epi32(x, idx);
+}
+__attribute__((target("avx2"))) inline __m256 permuteV(__m256 x, __m256i idx) {
+    return _mm256_permutevar8x32_ps(x, idx);
+}
+
+// Every step stores a full vector at a + l and scratch + r and then advances
+// l and r by the number of valid lanes; l <= i keeps the in-place store behind
+// the read position, and the 8 spare scratch slots absorb the overhang.
+template <bool OrEqual, typename T>
+__attribute__((target("avx2"))) size_t partition(T* a, size_t n, T pivot, T* scratch) {
+    const auto p = splatV(pivot);
+    size_t l = 0, r = 0, i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto x = loadV(a + i);
+        unsigned bits = leftBits<OrEqual>(x, p);
+        unsigned k = static_cast<unsigned>(__builtin_popcount(bits));
+        storeV(a + l, permuteV(x, lutAt(bits)));
+        storeV(scratch + r, permuteV(x, lutAt(~bits & 0xFFu)));
+        l += k;
+        r += 8 - k;
+    }
+    for (; i < n; i++) {
+        T x = a[i];
+        bool left = OrEqual ? !(pivot < x) : (x < pivot);
+        a[l] = x;
+        scratch[r] = x;
+        l += left;
+        r += !left;
+    }
+    memcpy(a + l, scratch, r * sizeof(T));
+    return l;
+}
+
+} // namespace avx2
+
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+}
+
+#endif // MULTI_SELECT_X86
+
+template <bool OrEqual, typename T>
+size_t partitionBy(T* a, size_t n, const T& pivot, T* scratch) {
+#ifdef MULTI_SELECT_X86
+    if constexpr (is_same_v<T, int32_t> || is_same_v<T, float>)
+        if (hasAvx2()) return avx2::partition<OrEqual>(a, n, pivot, scratch);
+#endif
+    return partitionScalar<OrEqual>(a, n, pivot, scratch);
+}
+
+// ---------------------------------------------------------
+// Parallel two-way partition
+// ---------------------------------------------------------
+// Phase 1: every thread partitions its own chunk (using its own slice of the
+// scratch buffer). Phase 2: each chunk scatters its left and right parts into
+// their final positions inside scratch. Phase 3: scratch is copied back.
+// scratch must hold n + 8 * threads elements.
+
+template <bool OrEqual, typename T>
+size_t partitionParallel(T* a, size_t n, const T& pivot, T* scratch, unsigned threads) {
+    vector<size_t> begin(threads + 1), leftCount(threads);
+    for (unsigned t = 0; t <= threads; t++) begin[t] = n * t / threads;
+
+    auto runAll = [&](auto&& body) {
+        vector<thread> pool;
+        for (unsigned t = 1; t < threads; t++) pool.emplace_back(body, t);
+        body(0u);
+        for (auto& th : pool) th.join();
+    };
+
+    runAll([&](unsigned t) {
+        leftCount[t] = partitionBy<OrEqual>(a + begin[t], begin[t + 1] - begin[t], pivot,
+                                            scratch + begin[t] + 8 * t);
+    });
+
+    vector<size_t> leftDst(threads), rightDst(threads);
+    size_t totalLeft = 0;
+    for (unsigned t = 0; t < threads; t++) { leftDst[t] = totalLeft; totalLeft += leftCount[t]; }
+    size_t rightPos = totalLeft;
+    for (unsigned t = 0; t < threads; t++) {
+        rightDst[t] = rightPos;
+        rightPos += (begin[t + 1] - begin[t]) - leftCount[t];
+    }
+
+    runAll([&](unsigned t) {
+        size_t len = begin[t + 1] - begin[t], l = leftCount[t];
+        memcpy(scratch + leftDst[t], a + begin[t], l * sizeof(T));
+        memcpy(scratch + rightDst[t], a + begin[t] + l, (len - l) * sizeof(T));
+    });
+    runAll([&](unsigned t) {
+        memcpy(a + begin[t], scratch + begin[t], (begin[t + 1] - begin[t]) * sizeof(T));
+    });
+    return totalLeft;
+}
+
+// ---------------------------------------------------------
+// Recursive multi-rank introselect
+// ---------------------------------------------------------
+
+template <typename T>
+const T& median3(const T& a, const T& b, const T& c) {
+    if (a < b) return b < c ? b : (a < c ? c : a);
+    return a < c ? a : (b < c ? c : b);
+}
+
+// Median of three medians-of-three spread over the range (Tukey's ninther).
+template <typename T>
+T choosePivot(const T* a, size_t n) {
+    size_t s = n / 8;
+    size_t m = n / 2;
+    return median3(median3(a[0], a[s], a[2 * s]),
+                   median3(a[m - s], a[m], a[m + s]),
+                   median3(a[n - 1 - 2 * s], a[n - 1 - s], a[n - 1]));
+}
+
+template <typename T>
+struct SelectContext {
+    T* base;              // start of the whole vector (ranks are absolute)
+    T* scratch;           // scratch[i] serves position scratchBase + i
+    size_t scratchBase;
+    unsigned threads;     // 1 for the sequential variant
+
+    T* scratchAt(size_t pos) const { return scratch + (pos - scratchBase); }
+};
+
+template <typename T>
+void selectRec(const SelectContext<T>& ctx, size_t lo, size_t hi,
+               const size_t* rb, const size_t* re, int depth) {
+    while (rb != re) {
+        T* a = ctx.base + lo;
+        size_t n = hi - lo;
+        if (n <= SmallSortCutoff) {
+            sort(a, a + n);
+            return;
+        }
+        if (depth-- == 0) {
+            // Introselect fallback: narrow the range rank by rank.
+            size_t from = lo;
+            for (const size_t* r = rb; r != re; ++r) {
+                nth_element(ctx.base + from, ctx.base + *r, ctx.base + hi);
+                from = *r + 1;
+            }
+            return;
+        }
+
+        T pivot = choosePivot(a, n);
+        bool par = ctx.threads > 1 && n >= ParallelCutoff;
+        T* scratch = ctx.scratchAt(lo);
+        size_t m1 = lo + (par ? partitionParallel<false>(a, n, pivot, scratch, ctx.threads)
+                              : partitionBy<false>(a, n, pivot, scratch));
+        const size_t* mid1 = lower_bound(rb, re, m1);
+        size_t m2 = m1;
+        const size_t* mid2 = mid1;
+        if (mid1 != re) {
+            // Pull the "== pivot" block out of the right side; it is never empty
+            // because the pivot itself is in the range.
+            T* b = ctx.base + m1;
+            m2 = m1 + (par ? partitionParallel<true>(b, hi - m1, pivot, ctx.scratchAt(m1), ctx.threads)
+                           : partitionBy<true>(b, hi - m1, pivot, ctx.scratchAt(m1)));
+            mid2 = lower_bound(mid1, re, m2);
+        }
+
+        bool leftWork = rb != mid1, rightWork = mid2 != re;
+        if (par && leftWork && rightWork) {
+            // Scratch overhangs the end of a subrange, so the concurrent left
+            // side gets its own buffer instead of sharing the right side's.
+            auto fut = async(launch::async, [&ctx, lo, m1, rb, mid1, depth] {
+                vector<T> own(m1 - lo + 8 * ctx.threads);
+                SelectContext<T> sub { ctx.base, own.data(), lo, ctx.threads };
+                selectRec(sub, lo, m1, rb, mid1, depth);
+            });
+            selectRec(ctx, m2, hi, mid2, re, depth);
+            fut.get();
+            return;
+        }
+        if (leftWork && rightWork) {
+            selectRec(ctx, lo, m1, rb, mid1, depth);
+            lo = m2; rb = mid2;
+        } else if (leftWork) {
+            hi = m1; re = mid1;
+        } else {
+            lo = m2; rb = mid2;
+        }
+    }
+}
+
+template <typename T>
+void multiSelectImpl(vector<T>& v, vector<size_t> ranks, unsigned threads) {
+    static_assert(is_trivially_copyable_v<T>, "multiSelect partitions with memcpy");
+    for (size_t r : ranks)
+        if (r >= v.size())
+            throw out_of_range("multiSelect: rank out of range");
+    sort(ranks.begin(), ranks.end());
+    ranks.erase(unique(ranks.begin(), ranks.end()), ranks.end());
+    if (ranks.empty()) return;
+
+    threads = max(1u, threads);
+    vector<T> scratch(v.size() + 8 * threads);
+    SelectContext<T> ctx { v.data(), scratch.data(), 0, threads };
+    int depth = 2 * static_cast<int>(log2(static_cast<double>(v.size())) + 1);
+    selectRec(ctx, 0, v.size(), ranks.data(), ranks.data() + ranks.size(), depth);
+}
+
+template <typename T>
+void multiSelect(vector<T>& v, const vector<size_t>& ranks) {
+    multiSelectImpl(v, ranks, 1);
+}
+
+template <typename T>
+void multiSelectParallel(vector<T>& v, const vector<size_t>& ranks,
+                         unsigned threads = thread::hardware_concurrency()) {
+    multiSelectImpl(v, ranks, threads);
+}
+
+inline size_t nearestRank(double q, size_t n) {
+    if (!(q >= 0.0 && q <= 1.0))
+        throw invalid_argument("quantile must be in [0, 1]");
+    double r = ceil(q * static_cast<double>(n)) - 1.0;
+    return static_cast<size_t>(min(max(r, 0.0), static_cast<double>(n - 1)));
+}
+
+template <typename T>
+vector<T> quantiles(vector<T>& v, const vector<double>& qs, bool parallel = false) {
+    if (v.empty())
+        throw out_of_range("quantiles of an empty vector");
+    vector<size_t> ranks;
+    for (double q : qs) ranks.push_back(nearestRank(q, v.size()));
+    if (parallel) multiSelectParallel(v, ranks);
+    else          multiSelect(v, ranks);
+    vector<T> out;
+    for (size_t r : ranks) out.push_back(v[r]);
+    return out;
+}
+
+template <typename T>
+void partialSortFast(vector<T>& v, size_t k) {
+    if (k > v.size())
+        throw out_of_range("partialSortFast: k > size()");
+    if (k == 0) return;
+    multiSelect(v, { k - 1 });
+    sort(v.begin(), v.begin() + k);
+}
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double bestMillis(int reps, F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < reps; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main() {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        vector<int> lat = { 12, 7, 95, 3, 41, 7, 8, 300, 15, 9, 11, 64, 7, 22, 5, 18 };
+        auto p = quantiles(lat, { 0.5, 0.9, 0.99 });
+        cout << "p50 = " << p[0] << ", p90 = " << p[1] << ", p99 = " << p[2] << "\n";   // 11 95 300
+
+        vector<int> v = { 9, 1, 8, 2, 7, 3, 6, 4, 5, 0 };
+        partialSortFast(v, 4);
+        cout << "partialSortFast(v, 4): ";
+        for (int x : v) cout << x << " ";   // 0 1 2 3 followed by the rest
+        cout << "\n";
+
+        try {
+            multiSelect(v, { 10 });
+        } catch (const out_of_range& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against std::sort
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check against std::sort\n";
+        mt19937 rng(3);
+        bool ok = true;
+        for (size_t n : { size_t(1), size_t(2), size_t(33), size_t(1000), size_t(100000), ParallelCutoff * 3 }) {
+            for (int mod : { 3, 1000000 }) {   // heavy duplicates and mostly distinct
+                vector<int32_t> v(n);
+                for (auto& x : v) x = static_cast<int32_t>(rng() % mod);
+                vector<int32_t> sorted = v;
+                sort(sorted.begin(), sorted.end());
+                vector<size_t> ranks = { 0, n / 2, n - 1, (n * 99) / 100, (n * 999) / 1000 };
+
+                vector<int32_t> a = v, b = v;
+                multiSelect(a, ranks);
+                multiSelectParallel(b, ranks, 4);
+                for (size_t r : ranks) {
+                    ok &= a[r] == sorted[r] && b[r] == sorted[r];
+                    for (size_t i = 0; i < n; i++)
+                        ok &= (i < r) ? a[i] <= a[r] && b[i] <= b[r] : a[i] >= a[r] && b[i] >= b[r];
+                }
+
+                vector<float> f(v.begin(), v.end()), fs(sorted.begin(), sorted.end());
+                multiSelect(f, ranks);
+                for (size_t r : ranks) ok &= f[r] == fs[r];
+
+                vector<int32_t> ps = v;
+                size_t k = n / 3;
+                partialSortFast(ps, k);
+                ok &= equal(ps.begin(), ps.begin() + k, sorted.begin());
+            }
+        }
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark (p50, p90, p99, p999 of a latency-like vector)
+    // ---------------------------------------------------------
+    {
+        cout << "Section C: Benchmark\n";
+        const size_t n = 10'000'000;
+        mt19937 rng(11);
+        lognormal_distribution<double> dist(5.0, 1.0);
+        vector<int32_t> base(n);
+        for (auto& x : base) x = static_cast<int32_t>(dist(rng));
+        vector<double> qs = { 0.5, 0.9, 0.99, 0.999 };
+        vector<size_t> ranks;
+        for (double q : qs) ranks.push_back(nearestRank(q, n));
+
+        vector<int32_t> work;
+        auto fresh = [&] { work = base; };
+        double tCopy = bestMillis(3, fresh);
+        double tNth = bestMillis(3, [&] {
+            fresh();
+            for (size_t r : ranks) nth_element(work.begin(), work.begin() + r, work.end());
+        }) - tCopy;
+        double tSort = bestMillis(3, [&] { fresh(); sort(work.begin(), work.end()); }) - tCopy;
+        double tMulti = bestMillis(3, [&] { fresh(); multiSelect(work, ranks); }) - tCopy;
+        double tPar = bestMillis(3, [&] { fresh(); multiSelectParallel(work, ranks); }) - tCopy;
+
+        cout << "n = " << n << ", quantiles p50/p90/p99/p999, threads = "
+             << thread::hardware_concurrency() << "\n";
+        cout << "  full std::sort           : " << tSort << " ms\n";
+        cout << "  repeated std::nth_element: " << tNth << " ms\n";
+        cout << "  multiSelect              : " << tMulti << " ms\n";
+        cout << "  multiSelectParallel      : " << tPar << " ms\n";
+
+        auto p = quantiles(work = base, qs);
+        cout << "  p50 = " << p[0] << ", p90 = " << p[1] << ", p99 = " << p[2] << ", p999 = " << p[3] << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+   ----------------------------------------------------------------------------
+   Loser Tree (Tournament Tree of Losers) for k-Way Merging
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - A loser tree keeps the current head of k sorted sources in a complete
+       binary tree stored in one flat array. Every internal node remembers
+       the LOSER of the match played there; the overall winner (the smallest
+       head) sits in node 0.
+     - After the winner is consumed, only the path from its leaf to the root
+       is replayed: one comparison per level, log2(k) in total, and each step
+       compares against a single stored node (a heap needs two comparisons
+       per level and swaps more).
+     - Nodes hold 32-bit source indices; the current head of every source
+       is cached in a k-element key array, so replaying touches two small
+       flat arrays and never dereferences the source ranges.
+
+   Member Functions (with Complexity):
+
+     1. LoserTree(k, comp)
+          - Creates a tree for k sources; every source starts exhausted.
+
+     2. set(i, key) / setExhausted(i)
+          - Initial head of source i (call for every source, then build()).
+
+     3. build()
+          - Plays all matches once. Complexity: O(k).
+
+     4. empty(), topSource(), topKey()
+          - Winner access. Complexity: O(1).
+
+     5. replaceTop(key) / popTop()
+          - The winner's source produced its next key / ran dry; replays one
+            leaf-to-root path. Complexity: O(log k).
+
+   Notes:
+     - Ties are broken by source index, so merging with a loser tree is
+       stable: equal keys come out in source order.
+     - Exhausted sources behave like +infinity; no sentinel value of T is
+       needed.
+
+   ----------------------------------------------------------------------------
+*/
+
+#ifndef LOSER_TREE_H
+#define LOSER_TREE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+template <typename T, typename Compare = std::less<T>>
+class LoserTree {
+public:
+    explicit LoserTree(size_t k, Compare comp = Compare())
+        : k_(k), leaves_(1), comp_(comp) {
+        while (leaves_ < k_) leaves_ *= 2;
+        tree_.assign(leaves_, 0);
+        keys_.assign(leaves_, T());
+        done_.assign(leaves_, 1);
+    }
+
+    size_t size() const { return k_; }
+
+    void set(size_t i, const T& key) { keys_[i] = key; done_[i] = 0; }
+    void setExhausted(size_t i) { done_[i] = 1; }
+
+    void build() { tree_[0] = leaves_ == 1 ? 0 : buildRec(1); }
+
+    bool empty() const { return done_[tree_[0]]; }
+    size_t topSource() const { return tree_[0]; }
+    const T& topKey() const { return keys_[tree_[0]]; }
+
+    void replaceTop(const T& key) {
+        uint32_t s = tree_[0];
+        keys_[s] = key;
+        replay(s);
+    }
+
+    void popTop() {
+        uint32_t s = tree_[0];
+        done_[s] = 1;
+        replay(s);
+    }
+
+private:
+    // a beats b: exhausted loses, then by key, then by source for stability.
+    // Plain branches measured faster than a cmov chain here: the replay path
+    // is a serial dependency, and speculation lets the next level start early.
+    bool beats(uint32_t a, uint32_t b) const {
+        if (done_[a] | done_[b])
+            return done_[a] == done_[b] ? a < b : done_[b];
+        if (comp_(keys_[a], keys_[b])) return true;
+        if (comp_(keys_[b], keys_[a])) return false;
+        return a < b;
+    }
+
+    uint32_t buildRec(size_t node) {
+        if (node >= leaves_) return static_cast<uint32_t>(node - leaves_);
+        uint32_t l = buildRec(node * 2), r = buildRec(node * 2 + 1);
+        if (beats(l, r)) { tree_[node] = r; return l; }
+        tree_[node] = l;
+        return r;
+    }
+
+    void replay(uint32_t cur) {
+        for (size_t node = (leaves_ + cur) / 2; node >= 1; node /= 2) {
+            uint32_t stored = tree_[node];
+            if (beats(stored, cur)) {
+                tree_[node] = cur;
+                cur = stored;
+            }
+        }
+        tree_[0] = cur;
+    }
+
+    size_t k_;
+    size_t leaves_;               // k rounded up to a power of two
+    Compare comp_;
+    std::vector<uint32_t> tree_;  // tree_[0] = winner, tree_[1..leaves_) = losers
+    std::vector<T> keys_;         // current head of every source
+    std::vector<uint8_t> done_;   // 1 once a source is exhausted
+};
+
+#endif // LOSER_TREE_H
@@ -0,0 +1,526 @@
+/*
+   ----------------------------------------------------------------------------
+   Adaptive Set Operations on Sorted Vectors: Galloping, SIMD Block Compare,
+   and k-Way Intersection
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - std::set_intersection, std::set_union and std::set_difference walk both
+       inputs element by element: O(|A| + |B|) even when one side has ten
+       elements and the other ten million.
+     - The functions below pick a strategy from the size ratio:
+
+       1. Galloping (exponential search), when one side is much smaller:
+            - For every element of the small side, search forward in the large
+              side from the previous position with steps 1, 2, 4, ... and
+              finish with a binary search inside the last step.
+            - Complexity: O(s log(l / s)) for sizes s << l.
+
+       2. SIMD block compare, when the sizes are similar (int32_t/uint32_t):
+            - Load 8 elements of each side, compare the A block against all 8
+              rotations of the B block (AVX2), and compact the matching (or,
+              for difference, non-matching) A lanes to the output with a
+              permutation lookup table. The block with the smaller last
+              element is advanced; no per-element branches.
+            - The CPU is checked once at run time; otherwise a scalar merge is
+              used.
+
+       3. k-way intersection:
+            - Lists are ordered by size; every element of the smallest list is
+              galloped for in the others (each keeps its own cursor) and dropped
+              as soon as one list misses it.
+            - Complexity: O(s * sum log(l_i / s)) for smallest size s.
+
+   Functions (with Complexity and Use Cases):
+
+     1. intersect(a, b)      : a ∩ b
+     2. unite(a, b)          : a ∪ b
+     3. subtract(a, b)       : a \ b
+     4. intersectK(lists)    : l_1 ∩ l_2 ∩ ... ∩ l_k
+          - Each returns a new sorted vector; the *Into(…, out) forms reuse the
+            capacity of an existing vector (useful in a query loop).
+          - Usage: auto hits = intersect(postingsA, postingsB);
+
+   Notes:
+     - Inputs must be sorted and strictly increasing (set semantics, as in a
+       posting list). For multisets keep using the std:: algorithms.
+     - GallopRatio is the size ratio at which galloping replaces the linear /
+       SIMD merge; 32 is a good default for 4-byte keys.
+
+   Compile:
+       g++ -std=c++17 -O2 adaptive_set_ops.cpp -o adaptive_set_ops
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>   // For std::set_intersection, std::set_union, std::set_difference
+#include <chrono>      // For benchmarking
+#include <cstdint>     // For uint32_t
+#include <cstring>     // For std::memcpy
+#include <iterator>    // For std::back_inserter
+#include <limits>      // For std::numeric_limits
+#include <random>      // For test data
+#include <type_traits> // For std::is_same_v
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SET_OPS_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+constexpr size_t GallopRatio = 32;
+
+// ---------------------------------------------------------
+// Galloping search
+// ---------------------------------------------------------
+// First position p >= from with !(data[p] < key), searching forward.
+
+template <typename T>
+size_t gallop(const T* data, size_t from, size_t n, const T& key) {
+    size_t lo = from, step = 1;
+    while (lo + step <= n && data[lo + step - 1] < key) {
+        lo += step;
+        step *= 2;
+    }
+    size_t hi = min(n, lo + step);
+    return static_cast<size_t>(lower_bound(data + lo, data + hi, key) - data);
+}
+
+// ---------------------------------------------------------
+// Scalar kernels: linear merge and galloping
+// ---------------------------------------------------------
+// All kernels append to out and return the new end.
+
+template <typename T>
+T* intersectLinear(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        T x = a[i], y = b[j];
+        *out = x;
+        out += (x == y);
+        i += (x <= y);
+        j += (y <= x);
+    }
+    return out;
+}
+
+// small (s) against large (l)
+template <typename T>
+T* intersectGallop(const T* s, size_t ns, const T* l, size_t nl, T* out) {
+    size_t pos = 0;
+    for (size_t i = 0; i < ns && pos < nl; i++) {
+        pos = gallop(l, pos, nl, s[i]);
+        if (pos < nl && l[pos] == s[i]) *out++ = s[i];
+    }
+    return out;
+}
+
+template <typename T>
+T* subtractLinear(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j])      *out++ = a[i++];
+        else if (b[j] < a[i]) j++;
+        else                  { i++; j++; }
+    }
+    memcpy(out, a + i, (na - i) * sizeof(T));
+    return out + (na - i);
+}
+
+// a much smaller than b: look every a up in b.
+template <typename T>
+T* subtractSmallFromLarge(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t pos = 0;
+    for (size_t i = 0; i < na; i++) {
+        pos = gallop(b, pos, nb, a[i]);
+        if (pos == nb || !(b[pos] == a[i])) *out++ = a[i];
+    }
+    return out;
+}
+
+// b much smaller than a: copy the stretches of a between elements of b.
+template <typename T>
+T* subtractLargeMinusSmall(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t cur = 0;
+    for (size_t j = 0; j < nb && cur < na; j++) {
+        size_t p = gallop(a, cur, na, b[j]);
+        memcpy(out, a + cur, (p - cur) * sizeof(T));
+        out += p - cur;
+        cur = (p < na && a[p] == b[j]) ? p + 1 : p;
+    }
+    memcpy(out, a + cur, (na - cur) * sizeof(T));
+    return out + (na - cur);
+}
+
+template <typename T>
+T* uniteLinear(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        T x = a[i], y = b[j];
+        *out++ = x < y ? x : y;
+        i += (x <= y);
+        j += (y <= x);
+    }
+    memcpy(out, a + i, (na - i) * sizeof(T));
+    out += na - i;
+    memcpy(out, b + j, (nb - j) * sizeof(T));
+    return out + (nb - j);
+}
+
+// s much smaller than l: copy the stretches of l, slotting in each s.
+template <typename T>
+T* uniteGallop(const T* s, size_t ns, const T* l, size_t nl, T* out) {
+    size_t cur = 0;
+    for (size_t i = 0; i < ns; i++) {
+        size_t p = gallop(l, cur, nl, s[i]);
+        memcpy(out, l + cur, (p - cur) * sizeof(T));
+        out += p - cur;
+        cur = p;
+        if (p < nl && l[p] == s[i]) continue;   // emitted with the next stretch
+        *out++ = s[i];
+    }
+    memcpy(out, l + cur, (nl - cur) * sizeof(T));
+    return out + (nl - cur);
+}
+
+// ---------------------------------------------------------
+// AVX2 block kernels (int32_t / uint32_t, equality only)
+// ---------------------------------------------------------
+
+#ifdef SET_OPS_X86
+
+namespace avx2 {
+
+// compactLut[bits] lists the lanes whose bit is set first.
+struct CompactLut {
+    alignas(32) array<array<uint32_t, 8>, 256> idx;
+    CompactLut() {
+        for (unsigned bits = 0; bits < 256; bits++) {
+            unsigned k = 0;
+            for (unsigned lane = 0; lane < 8; lane++)
+                if (bits & (1u << lane)) idx[bits][k++] = lane;
+            while (k < 8) idx[bits][k++] = 0;
+        }
+    }
+};
+static const CompactLut compactLut;
+
+// Bit l set when lane l of va equals any lane of vb.
+__attribute__((target("avx2"))) inline unsigned matchBits(__m256i va, __m256i vb) {
+    const __m256i rot = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; r++) {
+        vb = _mm256_permutevar8x32_epi32(vb, rot);
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+    }
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+}
+
+// Stores the lanes of va selected by bits at out (8 lanes written, so out
+// needs 8 slots of slack) and returns how many were selected.
+__attribute__((target("avx2"))) inline unsigned compactStore(uint32_t* out, __m256i va, unsigned bits) {
+    __m256i idx = _mm256_load_si256(reinterpret_cast<const __m256i*>(compactLut.idx[bits].data()));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(va, idx));
+    return static_cast<unsigned>(__builtin_popcount(bits));
+}
+
+__attribute__((target("avx2"))) inline __m256i load8(const uint32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Signed and unsigned keys only differ in how the block ends are compared.
+template <typename T>
+__attribute__((target("avx2"))) size_t intersect(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    auto ua = reinterpret_cast<const uint32_t*>(a);
+    auto ub = reinterpret_cast<const uint32_t*>(b);
+    auto uo = reinterpret_cast<uint32_t*>(out);
+    size_t i = 0, j = 0, k = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = load8(ua + i);
+        k += compactStore(uo + k, va, matchBits(va, load8(ub + j)));
+        T amax = a[i + 7], bmax = b[j + 7];
+        i += (amax <= bmax) ? 8 : 0;
+        j += (bmax <= amax) ? 8 : 0;
+    }
+    return static_cast<size_t>(intersectLinear(a + i, na - i, b + j, nb - j, out + k) - out);
+}
+
+// Matches for the current A block are accumulated over every B block it is
+// compared with; its unmatched lanes are emitted when the A block advances.
+template <typename T>
+__attribute__((target("avx2"))) size_t subtract(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    auto ua = reinterpret_cast<const uint32_t*>(a);
+    auto ub = reinterpret_cast<const uint32_t*>(b);
+    auto uo = reinterpret_cast<uint32_t*>(out);
+    size_t i = 0, j = 0, k = 0;
+    unsigned matched = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = load8(ua + i);
+        matched |= matchBits(va, load8(ub + j));
+        T amax = a[i + 7], bmax = b[j + 7];
+        if (amax <= bmax) {
+            k += compactStore(uo + k, va, ~matched & 0xFFu);
+            matched = 0;
+            i += 8;
+        }
+        j += (bmax <= amax) ? 8 : 0;
+    }
+    // Finish a partly compared A block against the B tail, then the rest.
+    if (matched != 0) {
+        size_t pos = j;
+        for (size_t l = 0; l < 8; l++) {
+            if (matched & (1u << l)) continue;
+            pos = gallop(b, pos, nb, a[i + l]);
+            if (pos == nb || !(b[pos] == a[i + l])) out[k++] = a[i + l];
+        }
+        i += 8;
+    }
+    return static_cast<size_t>(subtractLinear(a + i, na - i, b + j, nb - j, out + k) - out);
+}
+
+} // namespace avx2
+
+inline bool hasAvx2() {
+    static const bool ok = __builtin_cpu_supports("avx2");
+    return ok;
+}
+
+#endif // SET_OPS_X86
+
+template <typename T>
+constexpr bool simdKey = is_same_v<T, int32_t> || is_same_v<T, uint32_t>;
+
+// Every kernel writes at most min/sum of the input sizes plus 8 lanes of
+// SIMD overhang, so out is sized for that and trimmed afterwards.
+constexpr size_t SimdSlack = 8;
+
+// ---------------------------------------------------------
+// Public API
+// ---------------------------------------------------------
+
+template <typename T>
+void intersectInto(const vector<T>& a, const vector<T>& b, vector<T>& out) {
+    const vector<T>& s = a.size() <= b.size() ? a : b;
+    const vector<T>& l = a.size() <= b.size() ? b : a;
+    out.resize(s.size() + SimdSlack);
+    size_t k;
+    if (s.size() * GallopRatio < l.size()) {
+        k = intersectGallop(s.data(), s.size(), l.data(), l.size(), out.data()) - out.data();
+    } else {
+#ifdef SET_OPS_X86
+        if constexpr (simdKey<T>)
+            if (hasAvx2()) {
+                k = avx2::intersect(s.data(), s.size(), l.data(), l.size(), out.data());
+                out.resize(k);
+                return;
+            }
+#endif
+        k = intersectLinear(s.data(), s.size(), l.data(), l.size(), out.data()) - out.data();
+    }
+    out.resize(k);
+}
+
+template <typename T>
+void subtractInto(const vector<T>& a, const vector<T>& b, vector<T>& out) {
+    out.resize(a.size() + SimdSlack);
+    size_t k;
+    if (a.size() * GallopRatio < b.size()) {
+        k = subtractSmallFromLarge(a.data(), a.size(), b.data(), b.size(), out.data()) - out.data();
+    } else if (b.size() * GallopRatio < a.size()) {
+        k = subtractLargeMinusSmall(a.data(), a.size(), b.data(), b.size(), out.data()) - out.data();
+    } else {
+#ifdef SET_OPS_X86
+        if constexpr (simdKey<T>)
+            if (hasAvx2()) {
+                k = avx2::subtract(a.data(), a.size(), b.data(), b.size(), out.data());
+                out.resize(k);
+                return;
+            }
+#endif
+        k = subtractLinear(a.data(), a.size(), b.data(), b.size(), out.data()) - out.data();
+    }
+    out.resize(k);
+}
+
+template <typename T>
+void uniteInto(const vector<T>& a, const vector<T>& b, vector<T>& out) {
+    const vector<T>& s = a.size() <= b.size() ? a : b;
+    const vector<T>& l = a.size() <= b.size() ? b : a;
+    out.resize(a.size() + b.size());
+    size_t k = (s.size() * GallopRatio < l.size()
+                    ? uniteGallop(s.data(), s.size(), l.data(), l.size(), out.data())
+                    : uniteLinear(a.data(), a.size(), b.data(), b.size(), out.data())) - out.data();
+    out.resize(k);
+}
+
+template <typename T>
+void intersectKInto(const vector<const vector<T>*>& lists, vector<T>& out) {
+    out.clear();
+    if (lists.empty()) return;
+    vector<const vector<T>*> byLen = lists;
+    sort(byLen.begin(), byLen.end(), [](auto x, auto y) { return x->size() < y->size(); });
+
+    const vector<T>& smallest = *byLen[0];
+    vector<size_t> cursor(byLen.size(), 0);
+    for (const T& x : smallest) {
+        bool all = true;
+        for (size_t li = 1; li < byLen.size() && all; li++) {
+            const vector<T>& l = *byLen[li];
+            cursor[li] = gallop(l.data(), cursor[li], l.size(), x);
+            all = cursor[li] < l.size() && l[cursor[li]] == x;
+            // A list ran out: nothing after x can be in the intersection.
+            if (cursor[li] == l.size()) return;
+        }
+        if (all) out.push_back(x);
+    }
+}
+
+template <typename T> vector<T> intersect(const vector<T>& a, const vector<T>& b) { vector<T> o; intersectInto(a, b, o); return o; }
+template <typename T> vector<T> subtract(const vector<T>& a, const vector<T>& b)  { vector<T> o; subtractInto(a, b, o); return o; }
+template <typename T> vector<T> unite(const vector<T>& a, const vector<T>& b)     { vector<T> o; uniteInto(a, b, o); return o; }
+template <typename T> vector<T> intersectK(const vector<const vector<T>*>& lists) { vector<T> o; intersectKInto(lists, o); return o; }
+
+// ---------------------------------------------------------
+// Benchmark helpers
+// ---------------------------------------------------------
+
+template <typename F>
+double bestMicros(int reps, F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < reps; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, micro>(t1 - t0).count());
+    }
+    return best;
+}
+
+vector<uint32_t> randomSet(size_t n, uint32_t universe, mt19937& rng) {
+    vector<uint32_t> v(n);
+    for (auto& x : v) x = rng() % universe;
+    sort(v.begin(), v.end());
+    v.erase(unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+int main() {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        vector<int> a = { 1, 3, 5, 7, 9, 11, 13, 15, 17, 19 };
+        vector<int> b = { 3, 4, 5, 6, 7, 17, 30 };
+        auto print = [](const char* label, const vector<int>& v) {
+            cout << label;
+            for (int x : v) cout << x << " ";
+            cout << "\n";
+        };
+        print("intersect : ", intersect(a, b));   // 3 5 7 17
+        print("unite     : ", unite(a, b));
+        print("subtract  : ", subtract(a, b));    // 1 9 11 13 15 19
+        vector<int> c = { 5, 7, 17, 18 };
+        print("intersectK: ", intersectK<int>({ &a, &b, &c }));   // 5 7 17
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Cross-check against the std:: set algorithms
+    // ---------------------------------------------------------
+    {
+        cout << "Section B: Cross-check against <algorithm>\n";
+        mt19937 rng(8);
+        bool ok = true;
+        for (size_t na : { 0, 1, 7, 9, 100, 5000 }) {
+            for (size_t nb : { 0, 3, 8, 64, 5000, 200000 }) {
+                auto a = randomSet(na, 400000, rng), b = randomSet(nb, 400000, rng);
+                vector<uint32_t> e;
+                set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(e));
+                ok &= intersect(a, b) == e;
+                e.clear();
+                set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(e));
+                ok &= unite(a, b) == e;
+                e.clear();
+                set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(e));
+                ok &= subtract(a, b) == e;
+                e.clear();
+                set_difference(b.begin(), b.end(), a.begin(), a.end(), back_inserter(e));
+                ok &= subtract(b, a) == e;
+
+                // Signed keys through the SIMD path, dense so many lanes match.
+                vector<int32_t> sa, sb;
+                for (uint32_t x : a) sa.push_back(static_cast<int32_t>(x % 1000) - 500);
+                for (uint32_t x : b) sb.push_back(static_cast<int32_t>(x % 1000) - 500);
+                for (auto* v : { &sa, &sb }) {
+                    sort(v->begin(), v->end());
+                    v->erase(unique(v->begin(), v->end()), v->end());
+                }
+                vector<int32_t> se;
+                set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(), back_inserter(se));
+                ok &= intersect(sa, sb) == se;
+                se.clear();
+                set_difference(sa.begin(), sa.end(), sb.begin(), sb.end(), back_inserter(se));
+                ok &= subtract(sa, sb) == se;
+            }
+        }
+        auto x = randomSet(3000, 20000, rng), y = randomSet(9000, 20000, rng), z = randomSet(15000, 20000, rng);
+        vector<uint32_t> xy, xyz;
+        set_intersection(x.begin(), x.end(), y.begin(), y.end(), back_inserter(xy));
+        set_intersection(xy.begin(), xy.end(), z.begin(), z.end(), back_inserter(xyz));
+        ok &= intersectK<uint32_t>({ &z, &x, &y }) == xyz;
+        cout << "All results match: " << (ok ? "Yes" : "No") << "\n\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section C: Benchmark across size ratios (large side = 10^6)
+    // ---------------------------------------------------------
+    {
+        cout << "Section C: Benchmark (microseconds, large side ~10^6 of a 2^24 universe)\n";
+        cout << "   ratio   std::inter   inter   std::union   unite   std::diff   subtract\n";
+        mt19937 rng(21);
+        const uint32_t universe = 1u << 24;
+        auto large = randomSet(1000000, universe, rng);
+        vector<uint32_t> out, outStd;
+        outStd.reserve(2 * large.size());
+        for (size_t ratio : { 1, 10, 100, 1000, 10000, 100000 }) {
+            auto small = randomSet(large.size() / ratio, universe, rng);
+            int reps = 5;
+            double tsi = bestMicros(reps, [&] { outStd.clear(); set_intersection(small.begin(), small.end(), large.begin(), large.end(), back_inserter(outStd)); });
+            double ti = bestMicros(reps, [&] { intersectInto(small, large, out); });
+            double tsu = bestMicros(reps, [&] { outStd.clear(); set_union(small.begin(), small.end(), large.begin(), large.end(), back_inserter(outStd)); });
+            double tu = bestMicros(reps, [&] { uniteInto(small, large, out); });
+            double tsd = bestMicros(reps, [&] { outStd.clear(); set_difference(large.begin(), large.end(), small.begin(), small.end(), back_inserter(outStd)); });
+            double td = bestMicros(reps, [&] { subtractInto(large, small, out); });
+            cout << "  1:";
+            cout.width(6);  cout << left << ratio << right;
+            cout.width(11); cout << tsi;
+            cout.width(8);  cout << ti;
+            cout.width(13); cout << tsu;
+            cout.width(8);  cout << tu;
+            cout.width(12); cout << tsd;
+            cout.width(11); cout << td << "\n";
+        }
+
+        // k-way: intersect 4 posting lists of very different lengths.
+        vector<vector<uint32_t>> lists = { randomSet(2000000, universe, rng), randomSet(500000, universe, rng),
+                                           randomSet(50000, universe, rng), randomSet(5000, universe, rng) };
+        double tChain = bestMicros(5, [&] {
+            vector<uint32_t> acc = lists[0], tmp;
+            for (size_t i = 1; i < lists.size(); i++) {
+                tmp.clear();
+                set_intersection(acc.begin(), acc.end(), lists[i].begin(), lists[i].end(), back_inserter(tmp));
+                acc.swap(tmp);
+            }
+        });
+        double tK = bestMicros(5, [&] { intersectKInto<uint32_t>({ &lists[0], &lists[1], &lists[2], &lists[3] }, out); });
+        cout << "k-way (2M, 500K, 50K, 5K): chained std::set_intersection " << tChain
+             << " us, intersectK " << tK << " us\n";
+    }
+
+    return 0;
+}
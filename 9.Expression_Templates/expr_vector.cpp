@@ -0,0 +1,354 @@
+/*
+   ----------------------------------------------------------------------------
+   Expression-Template Numeric Vector Built on the Arithmetic Functors
+   ----------------------------------------------------------------------------
+
+   Overview:
+     - The Arithmetic Functors in stl_intro.txt (plus, minus, multiplies,
+       divides, modulus, negate) are usually combined with std::transform:
+
+           transform(a.begin(), a.end(), b.begin(), t.begin(), multiplies<>());
+           transform(t.begin(), t.end(), c.begin(), t.begin(), plus<>());
+           ...
+
+       Every step is a full pass over memory and needs a temporary vector.
+     - NumVec<T> overloads + - * / % and unary - to build a small expression
+       tree at compile time instead of computing anything. Each node stores
+       the functor (std::plus<T>, std::minus<T>, ...) and references to its
+       operands. Only assignment to a NumVec walks the data, once:
+
+           r = a * b + c - d;
+           // compiles to: for (i) r[i] = ((a[i] * b[i]) + c[i]) - d[i];
+
+       No temporaries are allocated, and since the loop body is a plain
+       elementwise expression the compiler can vectorize it.
+
+   Class NumVec<T> (with Complexity):
+
+     1. NumVec(n, value = T()), NumVec{ list }, NumVec(vector<T>)
+          - Owns a std::vector<T>; data(), size(), operator[], begin()/end().
+
+     2. Arithmetic: e1 op e2 for op in + - * / %, and -e
+          - Operands are NumVecs, other expressions, or scalars of type T
+            (broadcast). Building an expression is O(1).
+          - Operand sizes must match exactly (an empty vector does not match a
+            non-empty one); otherwise std::invalid_argument is thrown when the
+            expression is built.
+
+     3. Assignment: v = expr, v += expr, v -= expr, v *= expr, v /= expr
+          - One fused O(n) loop. If v is empty it is resized to the
+            expression's size.
+
+     4. sum(expr)
+          - Fused reduction without materializing the expression.
+
+   Notes:
+     - Expressions hold references to their operands, so they must be used
+       (assigned or reduced) within the same full-expression; do not store
+       one with auto past the lifetime of the vectors it refers to.
+     - Reading and writing the same vector (a = a * b + a) is safe: every
+       element only depends on operands at the same index.
+     - % uses std::modulus<T>, so it only compiles for integral T.
+
+   Compile:
+       g++ -std=c++17 -O2 expr_vector.cpp -o expr_vector
+   Run:
+       ./expr_vector [elements]
+
+   ----------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>   // For std::transform
+#include <chrono>      // For benchmarking
+#include <functional>  // For std::plus, std::minus, std::multiplies, std::divides, std::modulus, std::negate
+#include <initializer_list>
+#include <limits>      // For std::numeric_limits
+#include <stdexcept>   // For std::invalid_argument
+#include <string>      // For std::stoul
+#include <type_traits> // For std::enable_if_t, std::is_base_of_v, std::bool_constant
+
+using namespace std;
+
+// ---------------------------------------------------------
+// Expression base (CRTP) and node types
+// ---------------------------------------------------------
+
+// Every vector-valued expression derives from Expr<Derived> and provides
+// operator[](i) and size().
+template <typename Derived>
+struct Expr {
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+template <typename E>
+constexpr bool isExpr = is_base_of_v<Expr<E>, E>;
+
+// A scalar broadcast to every index.
+template <typename T>
+struct Scalar : Expr<Scalar<T>> {
+    T value;
+    explicit Scalar(T v) : value(v) {}
+    T operator[](size_t) const { return value; }
+    size_t size() const { return 0; }   // Unused: see isBroadcast
+};
+
+// True for expressions with no vector leaf. Those adapt to the other
+// operand's size; every other size has to match exactly, 0 included.
+template <typename E> struct IsBroadcast : false_type {};
+template <typename T> struct IsBroadcast<Scalar<T>> : true_type {};
+template <typename E> constexpr bool isBroadcast = IsBroadcast<E>::value;
+
+// Leaves (NumVec) are held by reference, inner nodes and scalars by value.
+template <typename T> class NumVec;
+template <typename E> struct Operand { using type = E; };
+template <typename T> struct Operand<NumVec<T>> { using type = const NumVec<T>&; };
+
+template <typename Op, typename L, typename R>
+struct BinaryExpr : Expr<BinaryExpr<Op, L, R>> {
+    typename Operand<L>::type l;
+    typename Operand<R>::type r;
+    size_t n;
+
+    BinaryExpr(const L& a, const R& b) : l(a), r(b) {
+        if (!isBroadcast<L> && !isBroadcast<R> && a.size() != b.size())
+            throw invalid_argument("NumVec expression: operand sizes differ");
+        n = isBroadcast<L> ? b.size() : a.size();
+    }
+    auto operator[](size_t i) const { return Op()(l[i], r[i]); }
+    size_t size() const { return n; }
+};
+
+template <typename Op, typename E>
+struct UnaryExpr : Expr<UnaryExpr<Op, E>> {
+    typename Operand<E>::type e;
+    explicit UnaryExpr(const E& x) : e(x) {}
+    auto operator[](size_t i) const { return Op()(e[i]); }
+    size_t size() const { return e.size(); }
+};
+
+template <typename Op, typename L, typename R>
+struct IsBroadcast<BinaryExpr<Op, L, R>> : bool_constant<isBroadcast<L> && isBroadcast<R>> {};
+template <typename Op, typename E>
+struct IsBroadcast<UnaryExpr<Op, E>> : IsBroadcast<E> {};
+
+// ---------------------------------------------------------
+// NumVec: owning vector that evaluates expressions on assignment
+// ---------------------------------------------------------
+
+template <typename T>
+class NumVec : public Expr<NumVec<T>> {
+public:
+    using value_type = T;
+
+    NumVec() = default;
+    explicit NumVec(size_t n, T value = T()) : data_(n, value) {}
+    NumVec(initializer_list<T> il) : data_(il) {}
+    explicit NumVec(vector<T> v) : data_(move(v)) {}
+
+    template <typename E, typename = enable_if_t<isExpr<E>>>
+    NumVec(const Expr<E>& e) : data_(e.self().size()) {
+        assignFrom(e.self(), [](T&, auto v) { return v; });
+    }
+
+    template <typename E>
+    NumVec& operator=(const Expr<E>& e) {
+        if (data_.empty()) data_.resize(e.self().size());
+        return assignFrom(e.self(), [](T&, auto v) { return v; });
+    }
+    template <typename E> NumVec& operator+=(const Expr<E>& e) { return assignFrom(e.self(), [](T& d, auto v) { return d + v; }); }
+    template <typename E> NumVec& operator-=(const Expr<E>& e) { return assignFrom(e.self(), [](T& d, auto v) { return d - v; }); }
+    template <typename E> NumVec& operator*=(const Expr<E>& e) { return assignFrom(e.self(), [](T& d, auto v) { return d * v; }); }
+    template <typename E> NumVec& operator/=(const Expr<E>& e) { return assignFrom(e.self(), [](T& d, auto v) { return d / v; }); }
+
+    T operator[](size_t i) const { return data_[i]; }
+    T& operator[](size_t i) { return data_[i]; }
+    size_t size() const { return data_.size(); }
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+    auto begin() { return data_.begin(); }
+    auto end() { return data_.end(); }
+    auto begin() const { return data_.begin(); }
+    auto end() const { return data_.end(); }
+    const vector<T>& vec() const { return data_; }
+
+private:
+    // The single fused loop every assignment goes through.
+    template <typename E, typename Combine>
+    NumVec& assignFrom(const E& e, Combine combine) {
+        if (!isBroadcast<E> && e.size() != data_.size())
+            throw invalid_argument("NumVec assignment: size mismatch");
+        T* d = data_.data();
+        const size_t n = data_.size();
+        for (size_t i = 0; i < n; i++)
+            d[i] = static_cast<T>(combine(d[i], e[i]));
+        return *this;
+    }
+
+    vector<T> data_;
+};
+
+// ---------------------------------------------------------
+// Operators
+// ---------------------------------------------------------
+// The element type of an expression is taken from its leaves; scalars are
+// converted to it so that "a * 2" works for NumVec<float>.
+
+template <typename E> struct ValueOf;
+template <typename T> struct ValueOf<NumVec<T>> { using type = T; };
+template <typename T> struct ValueOf<const NumVec<T>&> { using type = T; };
+template <typename T> struct ValueOf<Scalar<T>> { using type = T; };
+template <typename Op, typename E> struct ValueOf<UnaryExpr<Op, E>> { using type = typename ValueOf<E>::type; };
+template <typename Op, typename L, typename R> struct ValueOf<BinaryExpr<Op, L, R>> {
+    using type = typename ValueOf<conditional_t<is_same_v<L, Scalar<typename ValueOf<R>::type>>, R, L>>::type;
+};
+
+#define NUMVEC_BINARY_OP(sym, Functor)                                                          \
+    template <typename L, typename R>                                                           \
+    auto operator sym(const Expr<L>& a, const Expr<R>& b) {                                     \
+        using T = typename ValueOf<L>::type;                                                    \
+        return BinaryExpr<Functor<T>, L, R>(a.self(), b.self());                                \
+    }                                                                                           \
+    template <typename L, typename S, typename = enable_if_t<is_arithmetic_v<S>>>               \
+    auto operator sym(const Expr<L>& a, S s) {                                                  \
+        using T = typename ValueOf<L>::type;                                                    \
+        return BinaryExpr<Functor<T>, L, Scalar<T>>(a.self(), Scalar<T>(static_cast<T>(s)));    \
+    }                                                                                           \
+    template <typename S, typename R, typename = enable_if_t<is_arithmetic_v<S>>>               \
+    auto operator sym(S s, const Expr<R>& b) {                                                  \
+        using T = typename ValueOf<R>::type;                                                    \
+        return BinaryExpr<Functor<T>, Scalar<T>, R>(Scalar<T>(static_cast<T>(s)), b.self());    \
+    }
+
+NUMVEC_BINARY_OP(+, plus)
+NUMVEC_BINARY_OP(-, minus)
+NUMVEC_BINARY_OP(*, multiplies)
+NUMVEC_BINARY_OP(/, divides)
+NUMVEC_BINARY_OP(%, modulus)
+
+#undef NUMVEC_BINARY_OP
+
+template <typename E>
+auto operator-(const Expr<E>& e) {
+    return UnaryExpr<negate<typename ValueOf<E>::type>, E>(e.self());
+}
+
+template <typename E>
+auto sum(const Expr<E>& expr) {
+    const E& e = expr.self();
+    typename ValueOf<E>::type acc {};
+    for (size_t i = 0; i < e.size(); i++) acc += e[i];
+    return acc;
+}
+
+// ---------------------------------------------------------
+// Benchmark helper
+// ---------------------------------------------------------
+
+template <typename F>
+double bestMillis(int reps, F&& f) {
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < reps; r++) {
+        auto t0 = chrono::steady_clock::now();
+        f();
+        auto t1 = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    // ---------------------------------------------------------
+    // Section A: Basic usage
+    // ---------------------------------------------------------
+    {
+        cout << "Section A: Basic usage\n";
+        NumVec<int> a { 1, 2, 3, 4 }, b { 10, 20, 30, 40 }, c { 5, 5, 5, 5 }, d { 1, 1, 1, 1 };
+
+        NumVec<int> r = a * b + c - d;            // 14 44 94 164
+        cout << "a * b + c - d : ";
+        for (int x : r) cout << x << " ";
+        cout << "\n";
+
+        r = -(r % 7) + 2 * a;                      // scalars broadcast
+        cout << "-(r % 7) + 2a : ";
+        for (int x : r) cout << x << " ";
+        cout << "\n";
+
+        r += a;
+        cout << "r += a        : ";
+        for (int x : r) cout << x << " ";
+        cout << "\n";
+
+        cout << "sum(a * b)    : " << sum(a * b) << "\n";   // 300
+
+        try {
+            NumVec<int> shorter { 1, 2 };
+            r = a + shorter;
+        } catch (const invalid_argument& e) {
+            cout << "Exception: " << e.what() << "\n";
+        }
+        cout << "\n";
+    }
+
+    // ---------------------------------------------------------
+    // Section B: Benchmark a * b + c - d over float columns, size checks
+    // ---------------------------------------------------------
+    {
+        size_t n = argc > 1 ? stoul(argv[1]) : 10'000'000;
+        cout << "Section B: Benchmark r = a * b + c - d, n = " << n << " floats\n";
+        vector<float> va(n), vb(n), vc(n), vd(n);
+        for (size_t i = 0; i < n; i++) {
+            va[i] = float(i % 101) * 0.5f;
+            vb[i] = float(i % 37) + 1.0f;
+            vc[i] = float(i % 13);
+            vd[i] = float(i % 7) * 0.25f;
+        }
+        NumVec<float> a(va), b(vb), c(vc), d(vd), r(n);
+        vector<float> out(n);
+
+        // 1. Chained transform, each step allocating a fresh temporary.
+        double tAlloc = bestMillis(3, [&] {
+            vector<float> t1(n), t2(n);
+            transform(va.begin(), va.end(), vb.begin(), t1.begin(), multiplies<float>());
+            transform(t1.begin(), t1.end(), vc.begin(), t2.begin(), plus<float>());
+            transform(t2.begin(), t2.end(), vd.begin(), out.begin(), minus<float>());
+        });
+        // 2. Chained transform reusing the output vector (no allocation, 3 passes).
+        double tInPlace = bestMillis(3, [&] {
+            transform(va.begin(), va.end(), vb.begin(), out.begin(), multiplies<float>());
+            transform(out.begin(), out.end(), vc.begin(), out.begin(), plus<float>());
+            transform(out.begin(), out.end(), vd.begin(), out.begin(), minus<float>());
+        });
+        // 3. Hand-written fused loop (the target).
+        double tHand = bestMillis(3, [&] {
+            for (size_t i = 0; i < n; i++) out[i] = va[i] * vb[i] + vc[i] - vd[i];
+        });
+        // 4. Expression template.
+        double tExpr = bestMillis(3, [&] { r = a * b + c - d; });
+
+        bool same = true;
+        for (size_t i = 0; i < n; i++) same &= r[i] == out[i];
+        cout << "  transform chain (+temporaries): " << tAlloc << " ms\n";
+        cout << "  transform chain (in place)    : " << tInPlace << " ms\n";
+        cout << "  hand-written fused loop       : " << tHand << " ms\n";
+        cout << "  NumVec expression template    : " << tExpr << " ms\n";
+        cout << "  results identical: " << (same ? "Yes" : "No") << "\n";
+
+        // An empty operand must not pass for a broadcast one: every mix of
+        // an empty and a non-empty vector is rejected before any element is read.
+        auto throws = [](auto&& f) {
+            try { f(); } catch (const invalid_argument&) { return true; }
+            return false;
+        };
+        NumVec<int> empty, three { 1, 2, 3 };
+        bool rejected = throws([&] { NumVec<int> t = empty + three; })
+                     && throws([&] { NumVec<int> t = three * empty; })
+                     && throws([&] { NumVec<int> t = 2 * empty - three; })
+                     && throws([&] { NumVec<int> t = three; t += empty; });
+        cout << "  empty vs non-empty operands rejected: " << (rejected ? "Yes" : "No") << "\n";
+    }
+
+    return 0;
+}